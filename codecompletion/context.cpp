@@ -27,13 +27,19 @@
 
 #include "worker.h"
 #include "helpers.h"
+#include "declarationindex.h"
+#include "memberlistcache.h"
+#include "resultcache.h"
 #include "duchain/pythoneditorintegrator.h"
 #include "duchain/expressionvisitor.h"
 #include "duchain/declarationbuilder.h"
 #include "duchain/helpers.h"
+#include "duchain/moduleindex.h"
 #include "duchain/types/unsuretype.h"
 #include "duchain/navigation/navigationwidget.h"
 #include "parser/astbuilder.h"
+#include "parser/expressionastbuilder.h"
+#include "parser/lexicalstatecache.h"
 
 #include <language/duchain/functiondeclaration.h>
 #include <language/duchain/classdeclaration.h>
@@ -53,6 +59,7 @@
 #include <QRegExp>
 #include <KTextEditor/View>
 #include <memory>
+#include <algorithm>
 
 #include <QDebug>
 #include "codecompletiondebug.h"
@@ -62,6 +69,10 @@ using namespace KDevelop;
 
 namespace Python {
 
+// Items are only created for this many of the declarations which merely contain the typed characters
+// (see DeclarationIndex::find()); declarations starting with the typed prefix are always offered.
+const int maxDeclarationItems = 500;
+
 PythonCodeCompletionContext::ItemTypeHint PythonCodeCompletionContext::itemTypeHint()
 {
     return m_itemTypeHint;
@@ -76,8 +87,13 @@ std::unique_ptr<ExpressionVisitor> visitorForString(QString str, DUContext* cont
                                                     CursorInRevision scanUntil = CursorInRevision::invalid())
 {
     ENSURE_CHAIN_NOT_LOCKED
-    AstBuilder builder;
-    CodeAst::Ptr tmpAst = builder.parse({}, str);
+    // Most expressions can be handled without the python interpreter, which would mean waiting
+    // for background parse jobs to release it.
+    CodeAst::Ptr tmpAst = ExpressionAstBuilder::parse(str);
+    if ( ! tmpAst ) {
+        AstBuilder builder;
+        tmpAst = builder.parse({}, str);
+    }
     if ( ! tmpAst ) {
         return std::unique_ptr<ExpressionVisitor>(nullptr);
     }
@@ -116,6 +132,34 @@ static QList<CompletionTreeItemPointer> setOmitParentheses(QList<CompletionTreeI
     return items;
 };
 
+// The module index is filled in the background; until it covers @p path, look at the disk.
+static ModuleIndex::Directory directoryContents(const QString& path) {
+    ModuleIndex::Directory contents;
+    if ( ModuleIndex::self()->contents(path, &contents) ) {
+        return contents;
+    }
+    QDir directory(path);
+    foreach ( const QFileInfo& file, directory.entryInfoList(QDir::Files | QDir::Dirs | QDir::NoDotAndDotDot) ) {
+        if ( file.isFile() ) {
+            contents.files.insert(file.fileName());
+        }
+        else if ( ! file.fileName().contains('-') ) {
+            // Do not include items which contain "-", those are not valid
+            // modules but instead often e.g. .egg directories
+            contents.directories.insert(file.fileName());
+        }
+    }
+    return contents;
+}
+
+static bool hasSubdirectory(const QString& path, const QString& name) {
+    ModuleIndex::Directory contents;
+    if ( ModuleIndex::self()->contents(path, &contents) ) {
+        return contents.directories.contains(name);
+    }
+    return QFileInfo(path + '/' + name).isDir();
+}
+
 PythonCodeCompletionContext::ItemList PythonCodeCompletionContext::shebangItems()
 {
     KeywordItem::Flags f = (KeywordItem::Flags) ( KeywordItem::ForceLineBeginning | KeywordItem::ImportantItem );
@@ -334,6 +378,25 @@ PythonCodeCompletionContext::ItemList PythonCodeCompletionContext::inheritanceIt
 PythonCodeCompletionContext::ItemList PythonCodeCompletionContext::memberAccessItems()
 {
     ItemList resultingItems;
+    // While typing "os.pa", "os.pat", ... the items for "os." only need to be narrowed down.
+    const QString typed = typedPrefix();
+    CompletionResultCache::Key key;
+    if ( m_worker ) {
+        DUChainReadLocker lock;
+        if ( auto file = m_duContext->topContext()->parsingEnvironmentFile() ) {
+            key.context = m_duContext;
+            key.revision = file->modificationRevision();
+            key.operation = m_operation;
+            key.expression = m_guessTypeOfExpression;
+            key.position = m_position;
+            key.fullCompletion = m_fullCompletion;
+        }
+        if ( m_worker->resultCache().lookup(key, typed, &resultingItems) ) {
+            qCDebug(KDEV_PYTHON_CODECOMPLETION) << "narrowed down the previous items for" << m_guessTypeOfExpression;
+            return withMissingIncludeItems(resultingItems);
+        }
+    }
+
     auto v = visitorForString(m_guessTypeOfExpression, m_duContext.data());
     DUChainReadLocker lock;
     if ( v ) {
@@ -348,7 +411,14 @@ PythonCodeCompletionContext::ItemList PythonCodeCompletionContext::memberAccessI
     else {
         qCWarning(KDEV_PYTHON_CODECOMPLETION) << "Completion requested for syntactically invalid expression, not offering anything";
     }
+    if ( m_worker && key.context && ! m_itemsNarrowed ) {
+        m_worker->resultCache().store(key, typed, resultingItems);
+    }
+    return withMissingIncludeItems(resultingItems);
+}
 
+PythonCodeCompletionContext::ItemList PythonCodeCompletionContext::withMissingIncludeItems(ItemList resultingItems)
+{
     // append eventually stripped postfix, for e.g. os.chdir|
     bool needDot = true;
     foreach ( const QChar& c, m_followingText ) {
@@ -607,14 +677,12 @@ QList<CompletionTreeItemPointer> PythonCodeCompletionContext::completionItems(bo
         if ( abort ) {
             return ItemList();
         }
+        // Only create items for declarations matching what was typed already; the editor only
+        // narrows the list down further while typing continues.
+        const QString typed = typedPrefix();
         DUChainReadLocker lock;
-        QList<DeclarationDepthPair> declarations = m_duContext->allDeclarations(m_position, m_duContext->topContext());
-        foreach ( const DeclarationDepthPair& d, declarations ) {
-            if ( d.first && d.first->context()->type() == DUContext::Class ) {
-                declarations.removeAll(d);
-            }
-        }
-        resultingItems.append(declarationListToItemList(declarations));
+        const auto index = DeclarationIndex::forContext(m_duContext.data(), m_position);
+        resultingItems.append(declarationListToItemList(index.find(typed, typed.isEmpty() ? 0 : maxDeclarationItems)));
     }
     
     m_searchingForModule.clear();
@@ -650,7 +718,13 @@ QList<CompletionTreeItemPointer> PythonCodeCompletionContext::getMissingIncludeI
     }
 
     // See if there's a module called like that.
-    auto found = ContextBuilder::findModulePath(components.join("."), m_workingOnDocument);
+    const QString name = components.join(".");
+    const QList<QUrl> searchPaths = Helper::getSearchPaths(m_workingOnDocument);
+    ModuleIndex::self()->index(searchPaths);
+    QPair<QUrl, QStringList> found;
+    if ( ! ModuleIndex::self()->findModulePath(name, searchPaths, &found) ) {
+        found = ContextBuilder::findModulePath(name, m_workingOnDocument);
+    }
 
     // Check if anything was found
     if ( found.first.isValid() ) {
@@ -673,34 +747,42 @@ QList<CompletionTreeItemPointer> PythonCodeCompletionContext::getMissingIncludeI
     return items;
 }
 
+QString PythonCodeCompletionContext::typedPrefix() const
+{
+    QString typed;
+    foreach ( const QChar& c, m_followingText ) {
+        if ( ! c.isLetterOrNumber() && c != '_' ) {
+            break;
+        }
+        typed.append(c);
+    }
+    return typed;
+}
+
 QList<CompletionTreeItemPointer> PythonCodeCompletionContext::declarationListToItemList(QList<DeclarationDepthPair> declarations, int maxDepth)
 {
     QList<CompletionTreeItemPointer> items;
-    
-    DeclarationPointer currentDeclaration;
-    Declaration* checkDeclaration = 0;
-    int count = declarations.length();
-    for ( int i = 0; i < count; i++ ) {
-        if ( maxDepth && maxDepth > declarations.at(i).second ) {
+
+    // The items only look at their declarations once they are shown, so creating them is cheap.
+    // Still, for long lists, leave out most of the ones which only loosely match what was typed already.
+    const QString typed = typedPrefix();
+    if ( declarations.size() > maxDeclarationItems && ! typed.isEmpty() ) {
+        bool truncated = false;
+        declarations = DeclarationIndex(declarations).find(typed, maxDeclarationItems, &truncated);
+        m_itemsNarrowed = m_itemsNarrowed || truncated;
+    }
+
+    items.reserve(declarations.size());
+    foreach ( const DeclarationDepthPair& current, declarations ) {
+        if ( maxDepth && maxDepth > current.second ) {
             qCDebug(KDEV_PYTHON_CODECOMPLETION) << "Skipped completion item because of its depth";
             continue;
         }
-        currentDeclaration = DeclarationPointer(declarations.at(i).first);
-        
-        PythonDeclarationCompletionItem* item = 0;
-        checkDeclaration = Helper::resolveAliasDeclaration(currentDeclaration.data());
-        if ( ! checkDeclaration ) {
-            continue;
-        }
-        if ( checkDeclaration->isFunctionDeclaration()
-                || (checkDeclaration->internalContext() && checkDeclaration->internalContext()->type() == DUContext::Class) ) {
-            item = new FunctionDeclarationCompletionItem(currentDeclaration, KDevelop::CodeCompletionContext::Ptr(this));
-        }
-        else {
-            item = new PythonDeclarationCompletionItem(currentDeclaration, KDevelop::CodeCompletionContext::Ptr(this));
-        }
+        // whether it is a function or a class, and so is completed with a call, is decided by the item
+        auto item = new FunctionDeclarationCompletionItem(DeclarationPointer(current.first),
+                                                          KDevelop::CodeCompletionContext::Ptr(this));
         if ( ! m_matchAgainst.isEmpty() ) {
-            item->addMatchQuality(identifierMatchQuality(m_matchAgainst, checkDeclaration->identifier().toString()));
+            item->setMatchAgainst(m_matchAgainst);
         }
         items << CompletionTreeItemPointer(item);
     }
@@ -723,61 +805,68 @@ QList< CompletionTreeItemPointer > PythonCodeCompletionContext::getCompletionIte
         return getCompletionItemsForOneType(type);
     }
 
-    QList<CompletionTreeItemPointer> result;
+    // Do some weighting: the more often an entry appears, the better the entry.
+    // That way, entries which are in all of the types this object could have will
+    // be sorted higher up. Unless all items are requested, only one item is created per name.
+    QList<DeclarationDepthPair> declarations;
+    QHash<IndexedString, int> occurrences;
     UnsureType::Ptr unsure = type.cast<UnsureType>();
     int count = unsure->typesSize();
     for ( int i = 0; i < count; i++ ) {
-        result.append(getCompletionItemsForOneType(unsure->types()[i].abstractType()));
+        foreach ( const DeclarationDepthPair& current, memberDeclarationsForType(unsure->types()[i].abstractType()) ) {
+            int& seen = occurrences[current.first->identifier().identifier()];
+            if ( seen++ == 0 || m_fullCompletion ) {
+                declarations.append(current);
+            }
+        }
     }
-    // Do some weighting: the more often an entry appears, the better the entry.
-    // That way, entries which are in all of the types this object could have will
-    // be sorted higher up.
-    QStringList itemTitles;
-    QList<CompletionTreeItemPointer> remove;
-    for ( int i = 0; i < result.size(); i++ ) {
-        DeclarationPointer decl = result.at(i)->declaration();
+    QList<CompletionTreeItemPointer> result = declarationListToItemList(declarations);
+    foreach ( const CompletionTreeItemPointer& item, result ) {
+        DeclarationPointer decl = item->declaration();
         if ( ! decl ) {
-            itemTitles.append(QString());
             continue;
         }
-        const QString& title = decl->identifier().toString();
-        if ( itemTitles.contains(title) ) {
-            // there's already an item with that title, increase match quality
-            int item = itemTitles.indexOf(title);
-            PythonDeclarationCompletionItem* declItem = dynamic_cast<PythonDeclarationCompletionItem*>(result[item].data());
-            if ( ! m_fullCompletion ) {
-                remove.append(result.at(i));
-            }
-            if ( declItem ) {
-                // Add 1 to the match quality of the first item in the list.
-                declItem->addMatchQuality(1);
-            }
+        auto seen = occurrences.find(decl->identifier().identifier());
+        if ( seen == occurrences.end() || seen.value() < 2 ) {
+            continue;
         }
-        itemTitles.append(title);
-    }
-    foreach ( const CompletionTreeItemPointer& ptr, remove ) {
-        result.removeOne(ptr);
+        if ( auto declItem = dynamic_cast<PythonDeclarationCompletionItem*>(item.data()) ) {
+            // Add 1 to the match quality of the first item with that name for each other type providing it.
+            declItem->addMatchQuality(seen.value() - 1);
+        }
+        seen.value() = 0;
     }
     return result;
 }
 
 QList<CompletionTreeItemPointer> PythonCodeCompletionContext::getCompletionItemsForOneType(AbstractType::Ptr type)
+{
+    return declarationListToItemList(memberDeclarationsForType(type));
+}
+
+QList<DeclarationDepthPair> PythonCodeCompletionContext::memberDeclarationsForType(AbstractType::Ptr type)
 {
     type = Helper::resolveAliasType(type);
     ReferencedTopDUContext builtinTopContext = Helper::getDocumentationFileContext();
     if ( type->whichType() != AbstractType::TypeStructure ) {
-        return ItemList();
+        return {};
     }
     // find properties of class declaration
     TypePtr<StructureType> cls = StructureType::Ptr::dynamicCast(type);
     qCDebug(KDEV_PYTHON_CODECOMPLETION) << "Finding completion items for class type";
     if ( ! cls || ! cls->internalContext(m_duContext->topContext()) ) {
         qCWarning(KDEV_PYTHON_CODECOMPLETION) << "No class type available, no completion offered";
-        return QList<CompletionTreeItemPointer>();
+        return {};
+    }
+    // the same classes (e.g. self) are completed over and over again
+    Declaration* classDeclaration = cls->declaration(m_duContext->topContext());
+    QList<DeclarationDepthPair> keepDeclarations;
+    if ( classDeclaration && MemberListCache::lookup(classDeclaration, &keepDeclarations) ) {
+        qCDebug(KDEV_PYTHON_CODECOMPLETION) << "using cached members of" << classDeclaration->toString();
+        return keepDeclarations;
     }
     // the PublicOnly will filter out non-explictly defined __get__ etc. functions inherited from object
     QList<DUContext*> searchContexts = Helper::internalContextsForClass(cls, m_duContext->topContext(), Helper::PublicOnly);
-    QList<DeclarationDepthPair> keepDeclarations;
     foreach ( const DUContext* currentlySearchedContext, searchContexts ) {
         qCDebug(KDEV_PYTHON_CODECOMPLETION) << "searching context " << currentlySearchedContext->scopeIdentifier() << "for autocompletion items";
         QList<DeclarationDepthPair> declarations = currentlySearchedContext->allDeclarations(CursorInRevision::invalid(),
@@ -798,14 +887,30 @@ QList<CompletionTreeItemPointer> PythonCodeCompletionContext::getCompletionItems
             }
         }
     }
-    return declarationListToItemList(keepDeclarations);
+    // sorted like in a DeclarationIndex, so building one for narrowing down the list doesn't need to sort again
+    QVector<QPair<QString, DeclarationDepthPair>> byName;
+    byName.reserve(keepDeclarations.size());
+    foreach ( const DeclarationDepthPair& current, keepDeclarations ) {
+        byName.append(qMakePair(current.first->identifier().toString().toLower(), current));
+    }
+    std::stable_sort(byName.begin(), byName.end(), [](const QPair<QString, DeclarationDepthPair>& a,
+                                                      const QPair<QString, DeclarationDepthPair>& b) {
+        return a.first < b.first;
+    });
+    keepDeclarations.clear();
+    foreach ( const auto& current, byName ) {
+        keepDeclarations.append(current.second);
+    }
+    if ( classDeclaration ) {
+        MemberListCache::store(classDeclaration, searchContexts, keepDeclarations);
+    }
+    return keepDeclarations;
 }
 
 QList<CompletionTreeItemPointer> PythonCodeCompletionContext::findIncludeItems(IncludeSearchTarget item)
 {
     qCDebug(KDEV_PYTHON_CODECOMPLETION) << "TARGET:" << item.directory.path() << item.remainingIdentifiers;
-    QDir currentDirectory(item.directory.path());
-    QFileInfoList contents = currentDirectory.entryInfoList(QStringList(), QDir::Files | QDir::Dirs | QDir::NoDotAndDotDot);
+    const ModuleIndex::Directory contents = directoryContents(item.directory.path());
     bool atBottom = item.remainingIdentifiers.isEmpty();
     QList<CompletionTreeItemPointer> items;
     
@@ -813,8 +918,7 @@ QList<CompletionTreeItemPointer> PythonCodeCompletionContext::findIncludeItems(I
     
     if ( item.remainingIdentifiers.isEmpty() ) {
         // check for the __init__ file
-        QFileInfo initFile(item.directory.path(), "__init__.py");
-        if ( initFile.exists() ) {
+        if ( contents.files.contains(QStringLiteral("__init__.py")) ) {
             IncludeItem init;
             init.basePath = item.directory;
             init.isDirectory = true;
@@ -825,16 +929,16 @@ QList<CompletionTreeItemPointer> PythonCodeCompletionContext::findIncludeItems(I
                 ImportFileItem* importfile = new ImportFileItem(init);
                 importfile->moduleName = item.directory.fileName();
                 items << CompletionTreeItemPointer(importfile);
-                sourceFile = initFile.filePath();
+                sourceFile = QFileInfo(item.directory.path(), "__init__.py").filePath();
             }
         }
     }
     else {
-        QFileInfo file(item.directory.path(), item.remainingIdentifiers.first() + ".py");
+        const QString fileName = item.remainingIdentifiers.first() + ".py";
         item.remainingIdentifiers.removeFirst();
-        qCDebug(KDEV_PYTHON_CODECOMPLETION) << " CHECK:" << file.absoluteFilePath();
-        if ( file.exists() ) {
-            sourceFile = file.absoluteFilePath();
+        qCDebug(KDEV_PYTHON_CODECOMPLETION) << " CHECK:" << fileName;
+        if ( contents.files.contains(fileName) ) {
+            sourceFile = QFileInfo(item.directory.path(), fileName).absoluteFilePath();
         }
     }
     
@@ -856,29 +960,27 @@ QList<CompletionTreeItemPointer> PythonCodeCompletionContext::findIncludeItems(I
     
     if ( atBottom ) {
         // append all python files in the directory
-        foreach ( QFileInfo file, contents ) {
-            qCDebug(KDEV_PYTHON_CODECOMPLETION) << " > CONTENT:" << file.absolutePath() << file.fileName();
-            if ( file.isFile() ) {
-                if ( file.fileName().endsWith(".py") || file.fileName().endsWith(".so") ) {
-                    IncludeItem fileInclude;
-                    fileInclude.basePath = item.directory;
-                    fileInclude.isDirectory = false;
-                    fileInclude.name = file.fileName().mid(0, file.fileName().length() - 3); // remove ".py"
-                    ImportFileItem* import = new ImportFileItem(fileInclude);
-                    import->moduleName = fileInclude.name;
-                    items << CompletionTreeItemPointer(import);
-                }
-            }
-            else if ( ! file.fileName().contains('-') ) {
-                IncludeItem dirInclude;
-                dirInclude.basePath = item.directory;
-                dirInclude.isDirectory = true;
-                dirInclude.name = file.fileName();
-                ImportFileItem* import = new ImportFileItem(dirInclude);
-                import->moduleName = dirInclude.name;
+        foreach ( const QString& fileName, contents.files ) {
+            if ( fileName.endsWith(".py") || fileName.endsWith(".so") ) {
+                IncludeItem fileInclude;
+                fileInclude.basePath = item.directory;
+                fileInclude.isDirectory = false;
+                // remove ".py", or the ABI tag and ".so" of extension modules like "foo.cpython-35m-x86_64-linux-gnu.so"
+                fileInclude.name = fileName.left(fileName.indexOf('.'));
+                ImportFileItem* import = new ImportFileItem(fileInclude);
+                import->moduleName = fileInclude.name;
                 items << CompletionTreeItemPointer(import);
             }
         }
+        foreach ( const QString& directoryName, contents.directories ) {
+            IncludeItem dirInclude;
+            dirInclude.basePath = item.directory;
+            dirInclude.isDirectory = true;
+            dirInclude.name = directoryName;
+            ImportFileItem* import = new ImportFileItem(dirInclude);
+            import->moduleName = dirInclude.name;
+            items << CompletionTreeItemPointer(import);
+        }
     }
     return items;
 }
@@ -939,21 +1041,22 @@ QList<CompletionTreeItemPointer> PythonCodeCompletionContext::includeItemsForSub
     // Thus, we first generate a list of possible paths, then match them against those which actually exist
     // and then gather all the items in those paths.
     
+    ModuleIndex::self()->index(searchPaths);
     foreach ( QUrl currentPath, searchPaths ) {
-        auto d = QDir(currentPath.path());
+        QString path = QDir(currentPath.path()).absolutePath();
         qCDebug(KDEV_PYTHON_CODECOMPLETION) << "Searching: " << currentPath << subdirs;
         int identifiersUsed = 0;
         foreach ( const QString& subdir, subdirs ) {
             qCDebug(KDEV_PYTHON_CODECOMPLETION) << "changing into subdir" << subdir;
-            if ( ! d.cd(subdir) ) {
+            if ( ! hasSubdirectory(path, subdir) ) {
                 break;
             }
-            qCDebug(KDEV_PYTHON_CODECOMPLETION) << d.absolutePath() << d.exists();
+            path += '/' + subdir;
             identifiersUsed++;
         }
         QStringList remainingIdentifiers = subdirs.mid(identifiersUsed, -1);
-        foundPaths.append(IncludeSearchTarget(QUrl::fromLocalFile(d.absolutePath()), remainingIdentifiers));
-        qCDebug(KDEV_PYTHON_CODECOMPLETION) << "Found path:" << d.absolutePath() << remainingIdentifiers << subdirs;
+        foundPaths.append(IncludeSearchTarget(QUrl::fromLocalFile(path), remainingIdentifiers));
+        qCDebug(KDEV_PYTHON_CODECOMPLETION) << "Found path:" << path << remainingIdentifiers << subdirs;
     }
     return findIncludeItems(foundPaths);
 }
@@ -969,6 +1072,8 @@ PythonCodeCompletionContext::PythonCodeCompletionContext(DUContextPointer contex
     , m_guessTypeOfExpression(calledFunction)
     , m_alreadyGivenParametersCount(alreadyGivenParameters)
     , m_fullCompletion(false)
+    , m_itemsNarrowed(false)
+    , m_worker(nullptr)
 {
     ExpressionParser p(remainingText);
     summonParentForEventualCall(p.popAll(), remainingText);
@@ -1022,25 +1127,26 @@ void PythonCodeCompletionContext::summonParentForEventualCall(TokenList allExpre
 PythonCodeCompletionContext::PythonCodeCompletionContext(DUContextPointer context, const QString& text,
                                                          const QString& followingText,
                                                          const KDevelop::CursorInRevision& position,
-                                                         int depth, const PythonCodeCompletionWorker* /*parent*/)
+                                                         int depth, const PythonCodeCompletionWorker* parent)
     : CodeCompletionContext(context, text, position, depth)
     , m_operation(PythonCodeCompletionContext::DefaultCompletion)
     , m_itemTypeHint(NoHint)
     , m_child(0)
     , m_followingText(followingText)
     , m_position(position)
+    , m_itemsNarrowed(false)
+    , m_worker(parent)
 {
     m_workingOnDocument = context->topContext()->url().toUrl();
-    QString textWithoutStrings = CodeHelpers::killStrings(text);
+    // Only the lines changed since the last request are scanned again.
+    const LexicalState lexical = LexicalStateCache::state(m_workingOnDocument.toString(), text);
     
     qCDebug(KDEV_PYTHON_CODECOMPLETION) << text << position << context->localScopeIdentifier().toString() << context->range();
     
-    QPair<QString, QString> beforeAndAfterCursor = CodeHelpers::splitCodeByCursor(text,
-                                                                                  context->range().castToSimpleRange(),
-                                                                                  position.castToSimpleCursor());
+    const int beforeCursor = lexical.offsetOfCursor(context->range().castToSimpleRange(), position.castToSimpleCursor());
 
     // check if the current position is inside a multi-line comment -> no completion if this is the case
-    CodeHelpers::EndLocation location = CodeHelpers::endsInside(beforeAndAfterCursor.first);
+    CodeHelpers::EndLocation location = lexical.locationAt(beforeCursor);
     if ( location == CodeHelpers::Comment ) {
         m_operation = PythonCodeCompletionContext::NoCompletion;
         return;
@@ -1051,19 +1157,18 @@ PythonCodeCompletionContext::PythonCodeCompletionContext(DUContextPointer contex
     }
     
     // The expression parser used to determine the type of completion required.
+    // It only gets the current statement, so all offsets in its results are relative to the statement's beginning.
+    QString textWithoutStrings = CodeHelpers::killStrings(text.mid(lexical.lastStatementOffset()));
     ExpressionParser parser(textWithoutStrings);
     TokenList allExpressions = parser.popAll();
     allExpressions.reset(1);
     ExpressionParser::Status firstStatus = allExpressions.last().status;
     
-    // TODO reuse already calculated information
-    FileIndentInformation indents(text);
-    
     DUContext* currentlyChecked = context.data();
     // This will set the line to use for the completion to the beginning of the expression.
     // In reality, the line we're in might mismatch the beginning of the current expression,
     // for example in multi-line list initializers.
-    int currentlyCheckedLine = position.line - text.mid(text.length() - allExpressions.first().charOffset).count('\n');
+    int currentlyCheckedLine = position.line - textWithoutStrings.mid(allExpressions.first().charOffset).count('\n');
     
     // The following code will check whether the DUContext directly at the cursor should be used, or a previous one.
     // The latter might be the case if there's code like this:
@@ -1084,11 +1189,11 @@ PythonCodeCompletionContext::PythonCodeCompletionContext(DUContextPointer contex
             // FIXME: "<=" is not really good, it must be exactly one indent-level less
             int offset = position.line-currentlyChecked->range().start.line;
             // If the check leaves the current context, abort.
-            if ( offset >= indents.linesCount() ) {
+            if ( offset >= lexical.linesCount() ) {
                 break;
             }
-            if (    indents.indentForLine(indents.linesCount()-1-offset)
-                 <= indents.indentForLine(indents.linesCount()-1) )
+            if (    lexical.indentForLine(lexical.linesCount()-1-offset)
+                 <= lexical.indentForLine(lexical.linesCount()-1) )
             {
                 qCDebug(KDEV_PYTHON_CODECOMPLETION) << "changing context to" << currentlyChecked->range() 
                         << ( currentlyChecked->type() == DUContext::Class );
@@ -1125,7 +1230,8 @@ PythonCodeCompletionContext::PythonCodeCompletionContext(DUContextPointer contex
         }
     }
     
-    // For something like "func1(3, 5, func2(7, ", we want to show all calltips recursively
+    // For something like "func1(3, 5, func2(7, ", we want to show all calltips recursively;
+    // the calls are all in the current statement, so the parents only need its text
     summonParentForEventualCall(allExpressions, textWithoutStrings);
     
     if ( firstStatus == ExpressionParser::MeaninglessKeywordFound ) {
@@ -1159,7 +1265,7 @@ PythonCodeCompletionContext::PythonCodeCompletionContext(DUContextPointer contex
     
     if ( firstStatus == ExpressionParser::DefFound ) {
         if ( context->type() == DUContext::Class ) {
-            m_indent = QString(" ").repeated(indents.indentForLine(indents.linesCount()-1));
+            m_indent = QString(" ").repeated(lexical.indentForLine(lexical.linesCount()-1));
             m_operation = DefineCompletion;
         }
         else {
@@ -124,6 +124,10 @@ public:
      * @brief Get all items that are attributes of the given type. @param type must be non-unsure.
      **/
     QList<CompletionTreeItemPointer> getCompletionItemsForOneType(AbstractType::Ptr type);
+    /**
+     * @brief Get the declarations offered as attributes of the given type. @param type must be non-unsure.
+     **/
+    QList<DeclarationDepthPair> memberDeclarationsForType(AbstractType::Ptr type);
     
     /**
      * @brief Convert the given list of declarations to a list of include-items.
@@ -140,6 +144,8 @@ private:
     /// Get possible "add import..." items for an expression.
     QList< CompletionTreeItemPointer > getMissingIncludeItems(QString forString);
     void eventuallyAddGroup(QString name, int priority, QList<CompletionTreeItemPointer> items);
+    /// The part of the word being completed which was typed already.
+    QString typedPrefix() const;
 
 private:
     /// Item generating functions
@@ -152,6 +158,8 @@ private:
     ItemList importFileItems();
     ItemList inheritanceItems();
     ItemList memberAccessItems();
+    /// Appends "import ..." items for the accessed expression if @p resultingItems is empty.
+    ItemList withMissingIncludeItems(ItemList resultingItems);
     ItemList stringFormattingItems();
     ItemList keywordItems();
     ItemList classMemberInitItems();
@@ -179,6 +187,10 @@ private:
     QString m_matchAgainst;
 
     bool m_fullCompletion;
+    // whether declarationListToItemList() left out some items
+    bool m_itemsNarrowed;
+
+    const PythonCodeCompletionWorker* m_worker;
 
     QList<CompletionTreeElementPointer> m_storedGroups;
 };
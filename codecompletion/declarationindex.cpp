@@ -0,0 +1,229 @@
+/*****************************************************************************
+ * Copyright (c) 2026 agent <agent@local>                                    *
+ *                                                                           *
+ * This program is free software; you can redistribute it and/or             *
+ * modify it under the terms of the GNU General Public License as            *
+ * published by the Free Software Foundation; either version 2 of            *
+ * the License, or (at your option) any later version.                       *
+ *                                                                           *
+ * This program is distributed in the hope that it will be useful,           *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the             *
+ * GNU General Public License for more details.                              *
+ *                                                                           *
+ * You should have received a copy of the GNU General Public License         *
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.     *
+ *****************************************************************************
+ */
+
+#include "declarationindex.h"
+
+#include <language/duchain/declaration.h>
+#include <language/duchain/ducontext.h>
+#include <language/duchain/parsingenvironment.h>
+#include <language/duchain/topducontext.h>
+
+#include <QMutex>
+#include <QMutexLocker>
+
+#include <algorithm>
+#include <tuple>
+
+#include <QDebug>
+#include "codecompletiondebug.h"
+
+using namespace KDevelop;
+
+namespace Python {
+
+namespace {
+
+// whether all characters of @p needle appear in @p haystack, in the same order
+bool isSubsequence(const QString& needle, const QString& haystack)
+{
+    int atNeedle = 0;
+    const int needleLength = needle.size();
+    for ( int i = 0; i < haystack.size() && atNeedle < needleLength; i++ ) {
+        if ( haystack.at(i) == needle.at(atNeedle) ) {
+            atNeedle++;
+        }
+    }
+    return atNeedle == needleLength;
+}
+
+// Whether @p lowerNeedle can be matched by beginnings of the words of @p name, such as "gov" or "getov" for
+// "getOtherValue": each word either is skipped or contributes some of its first characters.
+bool isAbbreviation(const QString& lowerNeedle, const QString& name)
+{
+    QVector<int> wordStarts;
+    for ( int i = 0; i < name.size(); i++ ) {
+        const QChar c = name.at(i);
+        if ( c == '_' ) {
+            continue;
+        }
+        if ( i == 0 || name.at(i - 1) == '_' || ( c.isUpper() && ! name.at(i - 1).isUpper() ) ) {
+            wordStarts.append(i);
+        }
+    }
+    wordStarts.append(name.size());
+    const int needleLength = lowerNeedle.size();
+    const int words = wordStarts.size() - 1;
+    // matched[i * (words + 1) + w]: whether the needle from its i-th character on matches using words w and later
+    QVector<bool> matched((needleLength + 1) * (words + 1), false);
+    for ( int w = 0; w <= words; w++ ) {
+        matched[needleLength * (words + 1) + w] = true;
+    }
+    for ( int w = words - 1; w >= 0; w-- ) {
+        for ( int i = needleLength - 1; i >= 0; i-- ) {
+            bool& current = matched[i * (words + 1) + w];
+            current = matched[i * (words + 1) + w + 1];
+            for ( int at = wordStarts.at(w), n = i; ! current && at < wordStarts.at(w + 1) && n < needleLength; at++, n++ ) {
+                if ( name.at(at).toLower() != lowerNeedle.at(n) ) {
+                    break;
+                }
+                current = matched[(n + 1) * (words + 1) + w + 1];
+            }
+        }
+    }
+    return matched[0];
+}
+
+struct CachedIndex {
+    DUContextPointer context;
+    CursorInRevision position = CursorInRevision::invalid();
+    ModificationRevision revision;
+    DeclarationIndex index;
+};
+
+QMutex cacheMutex;
+CachedIndex cached;
+
+}
+
+DeclarationIndex::DeclarationIndex(const QList<DeclarationDepthPair>& declarations)
+{
+    m_entries.reserve(declarations.size());
+    foreach ( const DeclarationDepthPair& d, declarations ) {
+        if ( ! d.first ) {
+            continue;
+        }
+        const QString name = d.first->identifier().toString();
+        m_entries.append({name, name.toLower(), DeclarationPointer(d.first), d.second});
+    }
+    auto byName = [](const Entry& a, const Entry& b) {
+        return a.lowerName < b.lowerName;
+    };
+    // member lists come sorted already
+    if ( ! std::is_sorted(m_entries.begin(), m_entries.end(), byName) ) {
+        std::sort(m_entries.begin(), m_entries.end(), byName);
+    }
+}
+
+DeclarationIndex DeclarationIndex::forContext(DUContext* context, const CursorInRevision& position)
+{
+    const ParsingEnvironmentFilePointer file = context->topContext()->parsingEnvironmentFile();
+    QMutexLocker lock(&cacheMutex);
+    if ( file && cached.context.data() == context && cached.position == position
+         && cached.revision == file->modificationRevision() )
+    {
+        return cached.index;
+    }
+    // Class members are not accessible without "self." or similar.
+    QList<DeclarationDepthPair> declarations;
+    foreach ( const DeclarationDepthPair& d, context->allDeclarations(position, context->topContext()) ) {
+        if ( d.first && d.first->context() && d.first->context()->type() != DUContext::Class ) {
+            declarations.append(d);
+        }
+    }
+    DeclarationIndex index(declarations);
+    qCDebug(KDEV_PYTHON_CODECOMPLETION) << "built declaration index with" << index.size() << "entries";
+    if ( file ) {
+        cached.context = DUContextPointer(context);
+        cached.position = position;
+        cached.revision = file->modificationRevision();
+        cached.index = index;
+    }
+    return index;
+}
+
+QList<DeclarationDepthPair> DeclarationIndex::find(const QString& prefix, int limit, bool* truncated) const
+{
+    if ( truncated ) {
+        *truncated = false;
+    }
+    struct Candidate {
+        // 0: prefix, 1: prefix ignoring case, 2: beginnings of words, 3: characters in order
+        int quality;
+        int depth;
+        int entry;
+    };
+    QVector<Candidate> candidates;
+    const QString lowerPrefix = prefix.toLower();
+
+    // names starting with the prefix are next to each other
+    const auto first = std::lower_bound(m_entries.constBegin(), m_entries.constEnd(), lowerPrefix,
+                                        [](const Entry& entry, const QString& value) {
+        return entry.lowerName < value;
+    });
+    const int prefixBegin = first - m_entries.constBegin();
+    int prefixEnd = prefixBegin;
+    while ( prefixEnd < m_entries.size() && m_entries.at(prefixEnd).lowerName.startsWith(lowerPrefix) ) {
+        const Entry& entry = m_entries.at(prefixEnd);
+        candidates.append({entry.name.startsWith(prefix) ? 0 : 1, entry.depth, prefixEnd});
+        prefixEnd++;
+    }
+    int wordMatches = 0;
+    for ( int i = 0; i < m_entries.size(); i++ ) {
+        if ( i >= prefixBegin && i < prefixEnd ) {
+            continue;
+        }
+        const Entry& entry = m_entries.at(i);
+        if ( isSubsequence(lowerPrefix, entry.lowerName) ) {
+            const bool fromWords = isAbbreviation(lowerPrefix, entry.name);
+            wordMatches += fromWords;
+            candidates.append({fromWords ? 2 : 3, entry.depth, i});
+        }
+    }
+
+    auto better = [](const Candidate& a, const Candidate& b) {
+        return std::tie(a.quality, a.depth, a.entry) < std::tie(b.quality, b.depth, b.entry);
+    };
+    // The names starting with the prefix or matched by beginnings of words are never left out:
+    // the editor only narrows the list down while typing continues, so a name dropped now would be missing
+    // for any longer prefix too. Its filter doesn't show names only containing the typed characters somewhere.
+    const int keep = qMax(limit, prefixEnd - prefixBegin + wordMatches);
+    if ( limit > 0 && candidates.size() > keep ) {
+        std::partial_sort(candidates.begin(), candidates.begin() + keep, candidates.end(), better);
+        candidates.resize(keep);
+        if ( truncated ) {
+            *truncated = true;
+        }
+    }
+    else {
+        std::sort(candidates.begin(), candidates.end(), better);
+    }
+
+    QList<DeclarationDepthPair> result;
+    result.reserve(candidates.size());
+    foreach ( const Candidate& candidate, candidates ) {
+        const Entry& entry = m_entries.at(candidate.entry);
+        // the declaration might have been deleted since the index was built
+        if ( Declaration* declaration = entry.declaration.data() ) {
+            result.append(DeclarationDepthPair(declaration, entry.depth));
+        }
+    }
+    return result;
+}
+
+int DeclarationIndex::size() const
+{
+    return m_entries.size();
+}
+
+bool DeclarationIndex::matches(const QString& prefix, const QString& name)
+{
+    // a prefix is also a subsequence
+    return isSubsequence(prefix.toLower(), name.toLower());
+}
+
+}
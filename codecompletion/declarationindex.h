@@ -0,0 +1,91 @@
+/*****************************************************************************
+ * Copyright (c) 2026 agent <agent@local>                                    *
+ *                                                                           *
+ * This program is free software; you can redistribute it and/or             *
+ * modify it under the terms of the GNU General Public License as            *
+ * published by the Free Software Foundation; either version 2 of            *
+ * the License, or (at your option) any later version.                       *
+ *                                                                           *
+ * This program is distributed in the hope that it will be useful,           *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the             *
+ * GNU General Public License for more details.                              *
+ *                                                                           *
+ * You should have received a copy of the GNU General Public License         *
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.     *
+ *****************************************************************************
+ */
+
+#ifndef PYTHONDECLARATIONINDEX_H
+#define PYTHONDECLARATIONINDEX_H
+
+#include <language/duchain/duchainpointer.h>
+#include <language/editor/cursorinrevision.h>
+
+#include <QPair>
+#include <QString>
+#include <QVector>
+
+#include "pythoncompletionexport.h"
+
+namespace KDevelop {
+    class DUContext;
+    class Declaration;
+}
+
+namespace Python {
+
+typedef QPair<KDevelop::Declaration*, int> DeclarationDepthPair;
+
+/**
+ * @brief A list of declarations, sorted by name for prefix lookups.
+ *
+ * All functions require the DUChain to be read-locked.
+ */
+class KDEVPYTHONCOMPLETION_EXPORT DeclarationIndex
+{
+public:
+    DeclarationIndex() = default;
+    explicit DeclarationIndex(const QList<DeclarationDepthPair>& declarations);
+
+    /**
+     * @brief Get the index for the declarations visible at @p position in @p context.
+     * Declarations inside class scopes are left out.
+     *
+     * The index for the last position asked for is kept until the document is parsed again,
+     * so repeated requests at the same place don't collect and sort the declarations again.
+     */
+    static DeclarationIndex forContext(KDevelop::DUContext* context, const KDevelop::CursorInRevision& position);
+
+    /**
+     * @brief Get the declarations whose name matches @p prefix, best matches first.
+     *
+     * Names starting with @p prefix (case-sensitive before case-insensitive) come first, followed by names whose
+     * words begin with the parts of @p prefix, such as "gOV" or "getov" for "getOtherValue", and then by names which
+     * only contain the characters of @p prefix in order. Within each group, declarations from closer scopes are
+     * preferred. An empty prefix matches everything.
+     * If @p limit is positive, names of the last group are left out once there are that many results; the others
+     * are always returned. @p truncated is set to whether anything was left out.
+     */
+    QList<DeclarationDepthPair> find(const QString& prefix, int limit = 0, bool* truncated = nullptr) const;
+
+    int size() const;
+
+    /**
+     * @brief Whether @p name would be found by find() for @p prefix.
+     */
+    static bool matches(const QString& prefix, const QString& name);
+
+private:
+    struct Entry {
+        QString name;
+        QString lowerName;
+        KDevelop::DeclarationPointer declaration;
+        int depth;
+    };
+    QVector<Entry> m_entries; // sorted by lowerName
+};
+
+}
+
+#endif // PYTHONDECLARATIONINDEX_H
@@ -37,7 +37,7 @@
 #include "codecompletiondebug.h"
 
 #include "duchain/declarations/functiondeclaration.h"
-#include "parser/codehelpers.h"
+#include "parser/reversetokenizer.h"
 
 using namespace KDevelop;
 
@@ -95,50 +95,10 @@ int identifierMatchQuality(const QString& identifier1_, const QString& identifie
     return 0;
 }
 
-typedef QPair<QString, ExpressionParser::Status> keyword;
-
-static QList<keyword> supportedKeywords;
-static QList<keyword> controlChars;
-static QList<QString> miscKeywords;
-static QList<QString> noCompletionKeywords;
-static QMutex keywordPopulationLock;
-
-// Keywords known to me:
-// and       del       for       is        raise    
-// assert    elif      from      lambda    return   
-// break     else      global    not       try      
-// class     except    if        or        while    
-// continue  exec      import    pass      yield    
-// def       finally   in        print     with
-// async     await
-
 ExpressionParser::ExpressionParser(QString code)
     : m_code(code)
     , m_cursorPositionInString(m_code.length())
 {
-    keywordPopulationLock.lock();
-    if ( supportedKeywords.isEmpty() ) {
-        noCompletionKeywords << "break" << "class" << "continue" << "pass" << "try"
-                             << "else" << "as" << "finally" << "global" << "lambda";
-        miscKeywords << "and" << "assert" << "del" << "elif" << "exec" << "if" << "is" << "not" 
-                     << "or" << "print" << "return" << "while" << "yield" << "with" << "await";
-        supportedKeywords << keyword("import", ExpressionParser::ImportFound);
-        supportedKeywords << keyword("from", ExpressionParser::FromFound);
-        supportedKeywords << keyword("raise", ExpressionParser::RaiseFound);
-        supportedKeywords << keyword("in", ExpressionParser::InFound);
-        supportedKeywords << keyword("for", ExpressionParser::ForFound);
-        supportedKeywords << keyword("class", ExpressionParser::ClassFound);
-        supportedKeywords << keyword("def", ExpressionParser::DefFound);
-        supportedKeywords << keyword("except", ExpressionParser::ExceptFound);
-        controlChars << keyword(":", ExpressionParser::ColonFound);
-        controlChars << keyword(",", ExpressionParser::CommaFound);
-        controlChars << keyword("(", ExpressionParser::InitializerFound);
-        controlChars << keyword("{", ExpressionParser::InitializerFound);
-        controlChars << keyword("[", ExpressionParser::InitializerFound);
-        controlChars << keyword(".", ExpressionParser::MemberAccessFound);
-        controlChars << keyword("=", ExpressionParser::EqualsFound);
-    }
-    keywordPopulationLock.unlock();
 }
 
 QString ExpressionParser::getRemainingCode()
@@ -206,94 +166,72 @@ TokenList ExpressionParser::popAll()
     return items;
 }
 
-bool endsWithSeperatedKeyword(const QString& str, const QString& shouldEndWith) {
-    bool endsWith = str.endsWith(shouldEndWith);
-    if ( ! endsWith ) {
-        return false;
-    }
-    int l = shouldEndWith.length();
-    if ( str.length() == l ) {
-        return true;
+static ExpressionParser::Status statusForKeyword(ReverseTokenizer::Keyword keyword)
+{
+    switch ( keyword ) {
+        case ReverseTokenizer::ImportKeyword: return ExpressionParser::ImportFound;
+        case ReverseTokenizer::FromKeyword: return ExpressionParser::FromFound;
+        case ReverseTokenizer::RaiseKeyword: return ExpressionParser::RaiseFound;
+        case ReverseTokenizer::InKeyword: return ExpressionParser::InFound;
+        case ReverseTokenizer::ForKeyword: return ExpressionParser::ForFound;
+        case ReverseTokenizer::ClassKeyword: return ExpressionParser::ClassFound;
+        case ReverseTokenizer::DefKeyword: return ExpressionParser::DefFound;
+        case ReverseTokenizer::ExceptKeyword: return ExpressionParser::ExceptFound;
+        case ReverseTokenizer::BreakKeyword:
+        case ReverseTokenizer::ContinueKeyword:
+        case ReverseTokenizer::PassKeyword:
+        case ReverseTokenizer::TryKeyword:
+        case ReverseTokenizer::ElseKeyword:
+        case ReverseTokenizer::AsKeyword:
+        case ReverseTokenizer::FinallyKeyword:
+        case ReverseTokenizer::GlobalKeyword:
+        case ReverseTokenizer::LambdaKeyword:
+            return ExpressionParser::NoCompletionKeywordFound;
+        default:
+            return ExpressionParser::MeaninglessKeywordFound;
     }
-    if ( str.right(l + 1).at(0).isSpace() ) {
-        return true;
+}
+
+static ExpressionParser::Status statusForControlChar(QChar c)
+{
+    switch ( c.unicode() ) {
+        case ':': return ExpressionParser::ColonFound;
+        case ',': return ExpressionParser::CommaFound;
+        case '(': return ExpressionParser::EventualCallFound;
+        case '.': return ExpressionParser::MemberAccessFound;
+        case '=': return ExpressionParser::EqualsFound;
+        default: return ExpressionParser::InitializerFound; // { and [
     }
-    return false;
 }
 
 QString ExpressionParser::popExpression(ExpressionParser::Status* status)
 {
-    const auto remaining = getRemainingCode();
-    auto trimmed = remaining.trimmed();
-    auto operatingOn = trimmed.replace('\t', ' ');
-    bool lineIsEmpty = false;
-    for ( auto it = remaining.constEnd()-1; it != remaining.constEnd(); it-- ) {
-        if ( ! it->isSpace() ) {
-            break;
-        }
-        if ( *it == '\n' ) {
-            lineIsEmpty = true;
+    const ReverseTokenizer::Token token = ReverseTokenizer::previousToken(m_code, m_cursorPositionInString);
+    switch ( token.type ) {
+        case ReverseTokenizer::NoToken:
+        case ReverseTokenizer::EmptyLineToken:
+            m_cursorPositionInString = 0;
+            *status = NothingFound;
+            return QString();
+        case ReverseTokenizer::ControlToken:
+            m_cursorPositionInString = token.begin;
+            *status = statusForControlChar(m_code.at(token.begin));
+            return QString();
+        case ReverseTokenizer::KeywordToken:
+            m_cursorPositionInString = token.begin;
+            *status = statusForKeyword(token.keyword);
+            return QString();
+        case ReverseTokenizer::ExpressionToken:
             break;
-        }
     }
-    if ( operatingOn.isEmpty() || lineIsEmpty ) {
-        m_cursorPositionInString = 0;
+    // Otherwise, there's a real expression at the cursor.
+    m_cursorPositionInString = token.begin;
+    if ( token.begin == token.end ) {
         *status = NothingFound;
         return QString();
     }
-    bool lastCharIsSpace = getRemainingCode().right(1).at(0).isSpace();
-    m_cursorPositionInString -= trailingWhitespace();
-    if ( operatingOn.endsWith('(') ) {
-        qCDebug(KDEV_PYTHON_CODECOMPLETION) << "eventual call found";
-        m_cursorPositionInString -= 1;
-        *status = EventualCallFound;
-        return QString();
-    }
-    foreach ( const keyword& kw, controlChars ) {
-        if ( operatingOn.endsWith(kw.first) ) {
-            m_cursorPositionInString -= kw.first.length();
-            *status = kw.second;
-            return QString();
-        }
-    }
-    if ( lastCharIsSpace ) {
-        foreach ( const keyword& kw, supportedKeywords ) {
-            if ( endsWithSeperatedKeyword(operatingOn, kw.first) ) {
-                m_cursorPositionInString -= kw.first.length();
-                *status = kw.second;
-                return QString();
-            }
-        }
-        foreach ( const QString& kw, miscKeywords ) {
-            if ( endsWithSeperatedKeyword(operatingOn, kw) ) {
-                m_cursorPositionInString -= kw.length();
-                *status = MeaninglessKeywordFound;
-                return QString();
-            }
-        }
-        foreach ( const QString& kw, noCompletionKeywords ) {
-            if ( endsWithSeperatedKeyword(operatingOn, kw) ) {
-                m_cursorPositionInString -= kw.length();
-                *status = NoCompletionKeywordFound;
-                return QString();
-            }
-        }
-    }
-    // Otherwise, there's a real expression at the cursor, so scan it.
-    QStringList lines = operatingOn.split('\n');
-    Python::TrivialLazyLineFetcher f(lines);
-    int lastLine = lines.length()-1;
-    KTextEditor::Cursor startCursor;
-    QString expr = CodeHelpers::expressionUnderCursor(f, KTextEditor::Cursor(lastLine, f.fetchLine(lastLine).length() - 1),
-                                                      startCursor, true);
-    if ( expr.isEmpty() ) {
-        *status = NothingFound;
-    }
-    else {
-        *status = ExpressionFound;
-    }
-    m_cursorPositionInString -= expr.length();
-    return expr;
+    *status = ExpressionFound;
+    return m_code.mid(token.begin, token.end - token.begin);
 }
 
 
@@ -41,6 +41,7 @@ PythonDeclarationCompletionItem::PythonDeclarationCompletionItem(DeclarationPoin
                                : NormalDeclarationCompletionItem(decl, context, inheritanceDepth)
                                , m_typeHint(PythonCodeCompletionContext::NoHint)
                                , m_addMatchQuality(0)
+                               , m_identifierMatchQuality(-1)
 {
     Q_ASSERT(decl->alwaysForceDirect());
     if ( context ) {
@@ -53,6 +54,12 @@ void PythonDeclarationCompletionItem::addMatchQuality(int add)
     m_addMatchQuality += add;
 }
 
+void PythonDeclarationCompletionItem::setMatchAgainst(const QString& expression)
+{
+    m_matchAgainst = expression;
+    m_identifierMatchQuality = -1;
+}
+
 void PythonDeclarationCompletionItem::setTypeHint(PythonCodeCompletionContext::ItemTypeHint type)
 {
     m_typeHint = type;
@@ -86,13 +93,25 @@ QVariant PythonDeclarationCompletionItem::data(const QModelIndex& index, int rol
             {
                 return 10;
             }
+            if ( m_identifierMatchQuality == -1 ) {
+                m_identifierMatchQuality = 0;
+                if ( ! m_matchAgainst.isEmpty() ) {
+                    // for "from foo import bar as baz", rate "bar"
+                    const Declaration* named = Helper::resolveAliasDeclaration(declaration().data());
+                    if ( ! named ) {
+                        named = declaration().data();
+                    }
+                    m_identifierMatchQuality = identifierMatchQuality(m_matchAgainst, named->identifier().toString());
+                }
+            }
+            const int bonus = m_addMatchQuality + m_identifierMatchQuality;
             if ( model->completionContext()->duContext() == declaration()->context() ) {
-                return 5 + m_addMatchQuality;
+                return 5 + bonus;
             }
             if ( model->completionContext()->duContext()->topContext() == declaration()->context()->topContext() ) {
-                return 3 + m_addMatchQuality;
+                return 3 + bonus;
             }
-            return m_addMatchQuality;
+            return bonus;
         }
         case KDevelop::CodeCompletionModel::BestMatchesCount: {
             return 5;
@@ -36,10 +36,17 @@ public:
 
     void setTypeHint(PythonCodeCompletionContext::ItemTypeHint type);
     void addMatchQuality(int add);
+    /**
+     * @brief Rate the item higher the more its name looks like @p expression, e.g. for "foo_bar = |".
+     * The comparison is only done once the match quality is actually requested.
+     */
+    void setMatchAgainst(const QString& expression);
 
 protected:
     PythonCodeCompletionContext::ItemTypeHint m_typeHint;
     int m_addMatchQuality;
+    QString m_matchAgainst;
+    mutable int m_identifierMatchQuality;
 };
 
 } // namespace Python
@@ -22,6 +22,7 @@
 #include <language/codecompletion/codecompletionmodel.h>
 #include <language/duchain/types/functiontype.h>
 #include <language/duchain/aliasdeclaration.h>
+#include <language/duchain/ducontext.h>
 #include <language/duchain/types/containertypes.h>
 #include <shell/partcontroller.h>
 
@@ -48,10 +49,22 @@ FunctionDeclarationCompletionItem::FunctionDeclarationCompletionItem(Declaration
     , m_atArgument(-1)
     , m_depth(0)
     , m_doNotCall(false)
+    , m_callable(-1)
 {
 
 }
 
+bool FunctionDeclarationCompletionItem::isCallable() const
+{
+    if ( m_callable == -1 ) {
+        DUChainReadLocker lock;
+        const Declaration* resolved = Helper::resolveAliasDeclaration(m_declaration.data());
+        m_callable = resolved && ( resolved->isFunctionDeclaration()
+                                   || ( resolved->internalContext() && resolved->internalContext()->type() == DUContext::Class ) );
+    }
+    return m_callable == 1;
+}
+
 int FunctionDeclarationCompletionItem::atArgument() const
 {
     return m_atArgument;
@@ -74,6 +87,9 @@ int FunctionDeclarationCompletionItem::argumentHintDepth() const
 
 QVariant FunctionDeclarationCompletionItem::data(const QModelIndex& index, int role, const KDevelop::CodeCompletionModel* model) const
 {
+    if ( ! isCallable() ) {
+        return PythonDeclarationCompletionItem::data(index, role, model);
+    }
     DUChainReadLocker lock;
     FunctionDeclaration* dec = dynamic_cast<FunctionDeclaration*>(m_declaration.data());
     switch ( role ) {
@@ -136,6 +152,10 @@ void FunctionDeclarationCompletionItem::setDoNotCall(bool doNotCall)
 void FunctionDeclarationCompletionItem::executed(KTextEditor::View* view, const KTextEditor::Range& word)
 {
     qCDebug(KDEV_PYTHON_CODECOMPLETION) << "FunctionDeclarationCompletionItem executed";
+    if ( ! isCallable() ) {
+        PythonDeclarationCompletionItem::executed(view, word);
+        return;
+    }
     KTextEditor::Document* document = view->document();
     DeclarationPointer resolvedDecl(Helper::resolveAliasDeclaration(declaration().data()));
     DUChainReadLocker lock;
@@ -27,6 +27,12 @@ using namespace KDevelop;
 
 namespace Python {
 
+/**
+ * @brief Item for a declaration which is completed with a call if it is a function or a class.
+ *
+ * Whether the declaration (or the one it is an alias for) can be called is only looked up once the item
+ * is displayed or executed, so the items for long member lists are cheap to create.
+ */
 class FunctionDeclarationCompletionItem : public Python::PythonDeclarationCompletionItem
 {
 
@@ -42,11 +48,15 @@ public:
     QVariant data(const QModelIndex& index, int role, const CodeCompletionModel* model) const override;
     void executed(KTextEditor::View* view, const KTextEditor::Range& word) override;
 private:
+    bool isCallable() const;
+
     int m_atArgument;
     int m_depth;
     // indicates that no parentheses should be added when executing this item,
     // e.g. for import completion or inheritance
     bool m_doNotCall;
+    // -1 until it is looked up
+    mutable int m_callable;
 };
 
 }
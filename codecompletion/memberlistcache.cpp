@@ -0,0 +1,166 @@
+/*****************************************************************************
+ * Copyright (c) 2026 agent <agent@local>                                    *
+ *                                                                           *
+ * This program is free software; you can redistribute it and/or             *
+ * modify it under the terms of the GNU General Public License as            *
+ * published by the Free Software Foundation; either version 2 of            *
+ * the License, or (at your option) any later version.                       *
+ *                                                                           *
+ * This program is distributed in the hope that it will be useful,           *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the             *
+ * GNU General Public License for more details.                              *
+ *                                                                           *
+ * You should have received a copy of the GNU General Public License         *
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.     *
+ *****************************************************************************
+ */
+
+#include "memberlistcache.h"
+
+#include <language/duchain/classdeclaration.h>
+#include <language/duchain/declaration.h>
+#include <language/duchain/ducontext.h>
+#include <language/duchain/parsingenvironment.h>
+#include <language/duchain/topducontext.h>
+
+#include <QHash>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QVector>
+
+#include <algorithm>
+
+using namespace KDevelop;
+
+namespace Python {
+
+namespace {
+
+struct SearchedContext {
+    DUContextPointer context;
+    ModificationRevision revision;
+    QVector<IndexedType> baseClasses;
+};
+
+struct CacheEntry {
+    DeclarationPointer classDeclaration;
+    QVector<SearchedContext> searchedContexts;
+    QVector<QPair<DeclarationPointer, int>> members;
+    quint64 lastUse = 0;
+};
+
+const int maxCachedClasses = 64;
+QMutex cacheMutex;
+QHash<const Declaration*, CacheEntry> cache;
+quint64 useCounter = 0;
+
+bool revisionOf(const DUContext* context, ModificationRevision* revision)
+{
+    const ParsingEnvironmentFilePointer file = context->topContext()->parsingEnvironmentFile();
+    if ( ! file ) {
+        return false;
+    }
+    *revision = file->modificationRevision();
+    return true;
+}
+
+// Base classes which could not be resolved are left out of the class declaration.
+// When a dependency is parsed, the class is rebuilt with the same revision, but with more base classes.
+QVector<IndexedType> baseClassesOf(const DUContext* context)
+{
+    QVector<IndexedType> result;
+    const auto* classDeclaration = dynamic_cast<const ClassDeclaration*>(context->owner());
+    if ( ! classDeclaration ) {
+        return result;
+    }
+    FOREACH_FUNCTION( const BaseClassInstance& base, classDeclaration->baseClasses ) {
+        result.append(base.baseClass);
+    }
+    return result;
+}
+
+bool isUpToDate(const CacheEntry& entry, const Declaration* classDeclaration)
+{
+    // the pointer might belong to a new declaration, if the old one was deleted
+    if ( entry.classDeclaration.data() != classDeclaration ) {
+        return false;
+    }
+    foreach ( const SearchedContext& searched, entry.searchedContexts ) {
+        ModificationRevision revision;
+        if ( ! searched.context || ! revisionOf(searched.context.data(), &revision) || ! ( revision == searched.revision ) ) {
+            return false;
+        }
+        if ( baseClassesOf(searched.context.data()) != searched.baseClasses ) {
+            return false;
+        }
+    }
+    return true;
+}
+
+}
+
+bool MemberListCache::lookup(Declaration* classDeclaration, QList<DeclarationDepthPair>* members)
+{
+    QMutexLocker lock(&cacheMutex);
+    auto it = cache.find(classDeclaration);
+    if ( it == cache.end() ) {
+        return false;
+    }
+    if ( ! isUpToDate(*it, classDeclaration) ) {
+        cache.erase(it);
+        return false;
+    }
+    // a rebuild can delete members without changing the revision; leave @p members alone then
+    QList<DeclarationDepthPair> found;
+    found.reserve(it->members.size());
+    foreach ( const auto& member, it->members ) {
+        if ( ! member.first ) {
+            cache.erase(it);
+            return false;
+        }
+        found.append(DeclarationDepthPair(member.first.data(), member.second));
+    }
+    *members = found;
+    it->lastUse = ++useCounter;
+    return true;
+}
+
+void MemberListCache::store(Declaration* classDeclaration, const QList<DUContext*>& searchContexts,
+                            const QList<DeclarationDepthPair>& members)
+{
+    CacheEntry entry;
+    entry.classDeclaration = DeclarationPointer(classDeclaration);
+    foreach ( DUContext* context, searchContexts ) {
+        SearchedContext searched;
+        if ( ! revisionOf(context, &searched.revision) ) {
+            // can't tell when it changes
+            return;
+        }
+        searched.context = DUContextPointer(context);
+        searched.baseClasses = baseClassesOf(context);
+        entry.searchedContexts.append(searched);
+    }
+    entry.members.reserve(members.size());
+    foreach ( const DeclarationDepthPair& member, members ) {
+        entry.members.append(qMakePair(DeclarationPointer(member.first), member.second));
+    }
+
+    QMutexLocker lock(&cacheMutex);
+    if ( ! cache.contains(classDeclaration) && cache.size() >= maxCachedClasses ) {
+        auto oldest = std::min_element(cache.begin(), cache.end(), [](const CacheEntry& a, const CacheEntry& b) {
+            return a.lastUse < b.lastUse;
+        });
+        cache.erase(oldest);
+    }
+    entry.lastUse = ++useCounter;
+    cache.insert(classDeclaration, entry);
+}
+
+void MemberListCache::clear()
+{
+    QMutexLocker lock(&cacheMutex);
+    cache.clear();
+}
+
+}
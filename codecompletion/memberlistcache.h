@@ -0,0 +1,56 @@
+/*****************************************************************************
+ * Copyright (c) 2026 agent <agent@local>                                    *
+ *                                                                           *
+ * This program is free software; you can redistribute it and/or             *
+ * modify it under the terms of the GNU General Public License as            *
+ * published by the Free Software Foundation; either version 2 of            *
+ * the License, or (at your option) any later version.                       *
+ *                                                                           *
+ * This program is distributed in the hope that it will be useful,           *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the             *
+ * GNU General Public License for more details.                              *
+ *                                                                           *
+ * You should have received a copy of the GNU General Public License         *
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.     *
+ *****************************************************************************
+ */
+
+#ifndef PYTHONMEMBERLISTCACHE_H
+#define PYTHONMEMBERLISTCACHE_H
+
+#include "declarationindex.h"
+
+#include "pythoncompletionexport.h"
+
+namespace Python {
+
+/**
+ * @brief Keeps the member declarations offered for recently completed classes.
+ *
+ * An entry is used until the document of the class or of one of its base classes is modified,
+ * or until one of these classes gets different base classes, e.g. when an import is resolved.
+ * All functions require the DUChain to be read-locked.
+ */
+class KDEVPYTHONCOMPLETION_EXPORT MemberListCache
+{
+public:
+    /**
+     * @brief Get the members stored for the class declared by @p classDeclaration.
+     * @return false if there are none, or if one of the contexts they were collected from changed;
+     *         @p members is left unchanged then
+     */
+    static bool lookup(KDevelop::Declaration* classDeclaration, QList<DeclarationDepthPair>* members);
+
+    /**
+     * @brief Store the @p members collected from @p searchContexts for the class declared by @p classDeclaration.
+     */
+    static void store(KDevelop::Declaration* classDeclaration, const QList<KDevelop::DUContext*>& searchContexts,
+                      const QList<DeclarationDepthPair>& members);
+
+    static void clear();
+};
+
+}
+
+#endif // PYTHONMEMBERLISTCACHE_H
@@ -0,0 +1,71 @@
+/*****************************************************************************
+ * Copyright (c) 2026 agent <agent@local>                                    *
+ *                                                                           *
+ * This program is free software; you can redistribute it and/or             *
+ * modify it under the terms of the GNU General Public License as            *
+ * published by the Free Software Foundation; either version 2 of            *
+ * the License, or (at your option) any later version.                       *
+ *                                                                           *
+ * This program is distributed in the hope that it will be useful,           *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the             *
+ * GNU General Public License for more details.                              *
+ *                                                                           *
+ * You should have received a copy of the GNU General Public License         *
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.     *
+ *****************************************************************************
+ */
+
+#include "resultcache.h"
+
+#include "declarationindex.h"
+
+#include <language/duchain/declaration.h>
+
+#include <QMutexLocker>
+
+using namespace KDevelop;
+
+namespace Python {
+
+bool CompletionResultCache::Key::operator==(const Key& other) const
+{
+    return context == other.context && revision == other.revision && operation == other.operation
+           && expression == other.expression && position == other.position && fullCompletion == other.fullCompletion;
+}
+
+bool CompletionResultCache::lookup(const Key& key, const QString& typed, QList<CompletionTreeItemPointer>* items) const
+{
+    QMutexLocker lock(&m_mutex);
+    if ( ! m_valid || ! key.context || ! ( m_key == key ) || ! typed.startsWith(m_typed) ) {
+        return false;
+    }
+    items->clear();
+    foreach ( const CompletionTreeItemPointer& item, m_items ) {
+        const DeclarationPointer declaration = item->declaration();
+        if ( ! declaration || DeclarationIndex::matches(typed, declaration->identifier().toString()) ) {
+            items->append(item);
+        }
+    }
+    return true;
+}
+
+void CompletionResultCache::store(const Key& key, const QString& typed, const QList<CompletionTreeItemPointer>& items)
+{
+    QMutexLocker lock(&m_mutex);
+    m_valid = true;
+    m_key = key;
+    m_typed = typed;
+    m_items = items;
+}
+
+void CompletionResultCache::clear()
+{
+    QMutexLocker lock(&m_mutex);
+    m_valid = false;
+    m_key = Key();
+    m_typed.clear();
+    m_items.clear();
+}
+
+}
@@ -0,0 +1,79 @@
+/*****************************************************************************
+ * Copyright (c) 2026 agent <agent@local>                                    *
+ *                                                                           *
+ * This program is free software; you can redistribute it and/or             *
+ * modify it under the terms of the GNU General Public License as            *
+ * published by the Free Software Foundation; either version 2 of            *
+ * the License, or (at your option) any later version.                       *
+ *                                                                           *
+ * This program is distributed in the hope that it will be useful,           *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the             *
+ * GNU General Public License for more details.                              *
+ *                                                                           *
+ * You should have received a copy of the GNU General Public License         *
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.     *
+ *****************************************************************************
+ */
+
+#ifndef PYTHONCOMPLETIONRESULTCACHE_H
+#define PYTHONCOMPLETIONRESULTCACHE_H
+
+#include <language/codecompletion/codecompletionitem.h>
+#include <language/duchain/duchainpointer.h>
+#include <language/duchain/parsingenvironment.h>
+#include <language/editor/cursorinrevision.h>
+
+#include <QMutex>
+#include <QString>
+
+#include "pythoncompletionexport.h"
+
+namespace Python {
+
+/**
+ * @brief Keeps the items of the last completion request, so they can be narrowed down while typing continues.
+ *
+ * For "os.pa" followed by "os.pat", the items for the second request are the ones of the first request
+ * which still match the typed text; the expression does not have to be evaluated again.
+ */
+class KDEVPYTHONCOMPLETION_EXPORT CompletionResultCache
+{
+public:
+    struct Key {
+        KDevelop::DUContextPointer context;
+        KDevelop::ModificationRevision revision;
+        int operation = -1;
+        QString expression;
+        KDevelop::CursorInRevision position = KDevelop::CursorInRevision::invalid();
+        bool fullCompletion = false;
+
+        bool operator==(const Key& other) const;
+    };
+
+    /**
+     * @brief Get the items stored for @p key, if @p typed starts with the text typed when they were stored.
+     * Only the items whose declaration still matches @p typed are returned. Requires the DUChain to be read-locked.
+     * @return false if nothing usable is stored
+     */
+    bool lookup(const Key& key, const QString& typed, QList<KDevelop::CompletionTreeItemPointer>* items) const;
+
+    /**
+     * @brief Replace the stored items by @p items, which were computed for @p key with @p typed typed already.
+     * The list must not have been cut down to the best matches for @p typed, otherwise narrowing it would lose items.
+     */
+    void store(const Key& key, const QString& typed, const QList<KDevelop::CompletionTreeItemPointer>& items);
+
+    void clear();
+
+private:
+    mutable QMutex m_mutex;
+    bool m_valid = false;
+    Key m_key;
+    QString m_typed;
+    QList<KDevelop::CompletionTreeItemPointer> m_items;
+};
+
+}
+
+#endif // PYTHONCOMPLETIONRESULTCACHE_H
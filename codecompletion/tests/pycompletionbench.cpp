@@ -0,0 +1,249 @@
+/*****************************************************************************
+ * Copyright (c) 2026 agent <agent@local>                                    *
+ *                                                                           *
+ * This program is free software; you can redistribute it and/or             *
+ * modify it under the terms of the GNU General Public License as            *
+ * published by the Free Software Foundation; either version 2 of            *
+ * the License, or (at your option) any later version.                       *
+ *                                                                           *
+ * This program is distributed in the hope that it will be useful,           *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the             *
+ * GNU General Public License for more details.                              *
+ *                                                                           *
+ * You should have received a copy of the GNU General Public License         *
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.     *
+ *****************************************************************************
+ */
+
+#include "pycompletionbench.h"
+
+#include <QDebug>
+#include <QDir>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QFileInfo>
+#include <QStandardPaths>
+#include <QTextStream>
+#include <QtTest/QtTest>
+
+#include <language/backgroundparser/backgroundparser.h>
+#include <language/codegen/coderepresentation.h>
+#include <language/duchain/duchain.h>
+#include <language/duchain/duchainlock.h>
+#include <language/duchain/topducontext.h>
+#include <interfaces/ilanguagecontroller.h>
+#include <tests/autotestshell.h>
+#include <tests/testcore.h>
+
+#include <algorithm>
+#include <cmath>
+
+#include "codecompletion/context.h"
+#include "codecompletion/memberlistcache.h"
+#include "codecompletion/model.h"
+#include "codecompletion/worker.h"
+
+QTEST_MAIN(Python::PyCompletionBench)
+
+using namespace KDevelop;
+
+namespace Python {
+
+namespace {
+
+ReferencedTopDUContext parseFile(const QString& path)
+{
+    const IndexedString url(QUrl::fromLocalFile(path));
+    DUChain::self()->updateContextForUrl(url, KDevelop::TopDUContext::ForceUpdate);
+    ICore::self()->languageController()->backgroundParser()->parseDocuments();
+    return DUChain::self()->waitForUpdate(url, KDevelop::TopDUContext::AllDeclarationsContextsAndUses);
+}
+
+// latency below which @p p (0..1) of the sorted @p latencies are, in milliseconds
+double percentile(const QVector<qint64>& latencies, double p)
+{
+    const int index = qBound(0, int(std::ceil(p * latencies.size())) - 1, latencies.size() - 1);
+    return latencies.at(index) / 1000000.0;
+}
+
+// prints the percentiles of @p latencies and returns the 95th one
+double reportLatencies(const char* caches, QVector<qint64> latencies, int items)
+{
+    std::sort(latencies.begin(), latencies.end());
+    const double p95 = percentile(latencies, 0.95);
+    qDebug().noquote() << QTest::currentDataTag() << caches << ":" << latencies.size() << "requests," << items << "items;"
+                       << "p50" << QString::number(percentile(latencies, 0.5), 'f', 2) << "ms,"
+                       << "p95" << QString::number(p95, 'f', 2) << "ms,"
+                       << "p99" << QString::number(percentile(latencies, 0.99), 'f', 2) << "ms,"
+                       << "max" << QString::number(latencies.last() / 1000000.0, 'f', 2) << "ms";
+    return p95;
+}
+
+QString repeatDistinct(const QString& code, int count)
+{
+    QString result;
+    for ( int i = 0; i < count; i++ ) {
+        result.append(QString(code).replace("%X", QString::number(i)));
+    }
+    return result;
+}
+
+}
+
+PyCompletionBench::PyCompletionBench(QObject* parent)
+    : QObject(parent)
+{
+}
+
+void PyCompletionBench::initTestCase()
+{
+    AutoTestShell::init();
+    TestCore* core = new TestCore();
+    core->initialize(KDevelop::Core::NoUi);
+
+    auto doc_url = QDir::cleanPath(QStandardPaths::locate(QStandardPaths::GenericDataLocation,
+                                                          "kdevpythonsupport/documentation_files/builtindocumentation.py"));
+
+    DUChain::self()->updateContextForUrl(IndexedString(doc_url), KDevelop::TopDUContext::AllDeclarationsContextsAndUses);
+    ICore::self()->languageController()->backgroundParser()->parseDocuments();
+    DUChain::self()->waitForUpdate(IndexedString(doc_url), KDevelop::TopDUContext::AllDeclarationsContextsAndUses);
+
+    DUChain::self()->disablePersistentStorage();
+    KDevelop::CodeRepresentation::setDiskChangesForbidden(true);
+
+    createCorpus();
+}
+
+void PyCompletionBench::cleanupTestCase()
+{
+    TestCore::shutdown();
+}
+
+QString PyCompletionBench::writeFile(const QString& name, const QString& contents)
+{
+    const QString path = QDir(m_corpus.path()).absoluteFilePath(name);
+    QDir().mkpath(QFileInfo(path).absolutePath());
+    QFile f(path);
+    f.open(QIODevice::WriteOnly);
+    f.write(contents.toUtf8());
+    return path;
+}
+
+void PyCompletionBench::createCorpus()
+{
+    // a deep class hierarchy, with some members in each class
+    QString hierarchy;
+    QTextStream s(&hierarchy);
+    for ( int i = 0; i < 40; i++ ) {
+        s << "class Level" << i << "(" << ( i ? QStringLiteral("Level%1").arg(i - 1) : QStringLiteral("object") ) << "):\n";
+        s << "    def __init__(self):\n";
+        s << "        self.child = " << ( i ? QStringLiteral("Level%1()").arg(i - 1) : QStringLiteral("None") ) << "\n";
+        s << "        self.name" << i << " = 'level'\n";
+        for ( int m = 0; m < 10; m++ ) {
+            s << "    def method" << i << "_" << m << "(self, arg):\n";
+            s << "        return self.child\n";
+        }
+    }
+    s.flush();
+    parseFile(writeFile("deephierarchy.py", hierarchy));
+
+    // a large fake site-packages directory, the corpus directory is a search path for the sessions
+    QString module = repeatDistinct("def function%X(a, b=%X):\n    return [a, b]\n", 20)
+                   + repeatDistinct("class Class%X(object):\n    def method(self):\n        pass\n", 10);
+    for ( int p = 0; p < 200; p++ ) {
+        writeFile(QStringLiteral("pkg%1/__init__.py").arg(p), QStringLiteral("VERSION = %1\n").arg(p));
+        for ( int m = 0; m < 10; m++ ) {
+            writeFile(QStringLiteral("pkg%1/module%2.py").arg(p).arg(m), module);
+        }
+    }
+    // only the modules used by the sessions are parsed, like in a real session
+    parseFile(QDir(m_corpus.path()).absoluteFilePath("pkg42/module3.py"));
+    parseFile(QDir(m_corpus.path()).absoluteFilePath("pkg142/module7.py"));
+}
+
+void PyCompletionBench::benchTypingSession_data()
+{
+    QTest::addColumn<QString>("code");
+    QTest::addColumn<QString>("typed");
+
+    // "typed" is typed at %INVOKE character by character, and completion is requested after each one
+    QTest::newRow("member_access_deep_hierarchy")
+        << "from deephierarchy import *\nobj = Level39()\n%INVOKE\n"
+        << "obj.child.child.method37_4(obj.name38).child.name3";
+    QTest::newRow("import_completion_site_packages")
+        << "%INVOKE\n"
+        << "from pkg142.module7 import Class1";
+    QTest::newRow("import_package_names")
+        << "import os\n%INVOKE\n"
+        << "import pkg15";
+    QTest::newRow("calltips_nested_calls")
+        << "from deephierarchy import *\nfrom pkg42.module3 import *\nobj = Level20()\n%INVOKE\n"
+        << "result = function3(function5(obj.method18_2(function7(1, obj.child), [x for x in obj.name19]), 2), "
+           "obj.method20_1(";
+    QTest::newRow("huge_function")
+        << "import os\ndef huge(arg):\n" + repeatDistinct("    v%X = [%X, str(arg), os.path.join('a', 'b')]\n", 2000)
+           + "    %INVOKE\n" + repeatDistinct("    w%X = v%X.pop()\n", 200)
+        << "result = v1999.append(os.path.jo";
+    QTest::newRow("many_globals")
+        << repeatDistinct("global_value%X = %X\n", 3000) + "%INVOKE\n"
+        << "value = global_value2";
+}
+
+void PyCompletionBench::benchTypingSession()
+{
+    QFETCH(QString, code);
+    QFETCH(QString, typed);
+
+    const QString path = writeFile(QStringLiteral("session%1.py").arg(m_sessionFiles++), QString(code).replace("%INVOKE", ""));
+    const ReferencedTopDUContext top = parseFile(path);
+    QVERIFY(top);
+
+    PythonCodeCompletionModel model(nullptr);
+    PythonCodeCompletionWorker worker(&model, QUrl::fromLocalFile(path));
+    const QString before = code.left(code.indexOf("%INVOKE"));
+
+    // the first round is with cold caches, the others are like typing the same thing again;
+    // they are reported separately, since the warm rounds are mostly answered from the caches
+    MemberListCache::clear();
+    const int rounds = 3;
+    QVector<qint64> coldLatencies;
+    QVector<qint64> warmLatencies;
+    int coldItems = 0;
+    int warmItems = 0;
+    for ( int round = 0; round < rounds; round++ ) {
+        QVector<qint64>& latencies = round == 0 ? coldLatencies : warmLatencies;
+        int& items = round == 0 ? coldItems : warmItems;
+        for ( int i = 1; i <= typed.size(); i++ ) {
+            // like the completion worker, complete at the beginning of the word being typed
+            const QString text = typed.left(i);
+            int wordStart = text.size();
+            while ( wordStart > 0 && ( text.at(wordStart - 1).isLetterOrNumber() || text.at(wordStart - 1) == '_' ) ) {
+                wordStart--;
+            }
+            const QString snip = before + text.left(wordStart);
+            const QString following = text.mid(wordStart);
+            const CursorInRevision cursor(snip.count('\n'), snip.size() - snip.lastIndexOf('\n') - 1);
+            DUContextPointer context;
+            {
+                DUChainReadLocker lock;
+                context = DUContextPointer(top->findContextAt(cursor, true));
+            }
+            QVERIFY(context);
+
+            QElapsedTimer timer;
+            timer.start();
+            CodeCompletionContext::Ptr completion(new PythonCodeCompletionContext(context, snip, following, cursor,
+                                                                                  0, &worker));
+            bool abort = false;
+            const QList<CompletionTreeItemPointer> result = completion->completionItems(abort, false);
+            latencies.append(timer.nsecsElapsed());
+            items += result.size();
+        }
+    }
+
+    QTest::setBenchmarkResult(reportLatencies("cold", coldLatencies, coldItems), QTest::WalltimeMilliseconds);
+    reportLatencies("warm", warmLatencies, warmItems);
+}
+
+}
@@ -0,0 +1,58 @@
+/*****************************************************************************
+ * Copyright (c) 2026 agent <agent@local>                                    *
+ *                                                                           *
+ * This program is free software; you can redistribute it and/or             *
+ * modify it under the terms of the GNU General Public License as            *
+ * published by the Free Software Foundation; either version 2 of            *
+ * the License, or (at your option) any later version.                       *
+ *                                                                           *
+ * This program is distributed in the hope that it will be useful,           *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the             *
+ * GNU General Public License for more details.                              *
+ *                                                                           *
+ * You should have received a copy of the GNU General Public License         *
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.     *
+ *****************************************************************************
+ */
+
+#ifndef PYCOMPLETIONBENCH_H
+#define PYCOMPLETIONBENCH_H
+
+#include <QObject>
+#include <QTemporaryDir>
+
+namespace Python {
+
+/**
+ * @brief Replays typing sessions and measures how long each completion request takes.
+ *
+ * Every typed character of a session is one request: a PythonCodeCompletionContext is created
+ * and asked for its items, like the completion worker does. A session is typed once with cold caches
+ * and then twice more; the 50th, 95th and 99th percentile of the request latencies are reported
+ * for the cold and the warm rounds separately. The cold 95th percentile is the benchmark result.
+ */
+class PyCompletionBench : public QObject
+{
+    Q_OBJECT
+public:
+    explicit PyCompletionBench(QObject* parent = 0);
+
+private slots:
+    void initTestCase();
+    void cleanupTestCase();
+    void benchTypingSession_data();
+    void benchTypingSession();
+
+private:
+    /// Write the modules and packages the sessions import into the corpus directory, and parse the modules.
+    void createCorpus();
+    QString writeFile(const QString& name, const QString& contents);
+
+    QTemporaryDir m_corpus;
+    int m_sessionFiles = 0;
+};
+
+}
+
+#endif // PYCOMPLETIONBENCH_H
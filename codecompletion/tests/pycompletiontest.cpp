@@ -88,6 +88,18 @@ void makefile(QString filename, QString contents) {
     DUChain::self()->waitForUpdate(urlstring, KDevelop::TopDUContext::AllDeclarationsContextsAndUses);
 }
 
+// parses the document of @p context again, although it was not modified
+void reparseUnchanged(const DUContextPointer& context) {
+    IndexedString url;
+    {
+        DUChainReadLocker lock;
+        url = context->topContext()->url();
+    }
+    DUChain::self()->updateContextForUrl(url, KDevelop::TopDUContext::ForceUpdate);
+    ICore::self()->languageController()->backgroundParser()->parseDocuments();
+    DUChain::self()->waitForUpdate(url, KDevelop::TopDUContext::AllDeclarationsAndContexts);
+}
+
 void PyCompletionTest::initShell()
 {
     AutoTestShell::init();
@@ -186,6 +198,9 @@ void PyCompletionTest::testExpressionParser_data()
     QTest::newRow("initializer") << "my_list = [" << (int) ExpressionParser::InitializerFound << "";
     QTest::newRow("fancy_initializer") << "my_list = [1, 2, 3, 4, []" << (int) ExpressionParser::ExpressionFound << "[]";
     QTest::newRow("def") << "def " << (int) ExpressionParser::DefFound << "";
+    QTest::newRow("multiline_call") << "x = foo(a,\n    b).c" << (int) ExpressionParser::ExpressionFound << "foo(a,\n    b).c";
+    QTest::newRow("multiline_empty_line") << "foo(a,\n\n    b.c" << (int) ExpressionParser::ExpressionFound << "b.c";
+    QTest::newRow("empty_line") << "foo.bar\n  \n" << (int) ExpressionParser::NothingFound << "";
 }
 
 const QList<CompletionTreeItem*> PyCompletionTest::invokeCompletionOn(const QString& initCode, const QString& invokeCode)
@@ -402,6 +417,29 @@ void PyCompletionTest::testIntegralExpressionsDifferentContexts_data()
     QTest::newRow("print_stmt") << "%INVOKE" << "print([].%CURSOR" << "append";
 }
 
+void PyCompletionTest::testMultiLineStatementInNestedScope()
+{
+    QFETCH(QString, completionCode);
+    QFETCH(QString, expectedDeclaration);
+
+    QVERIFY(declarationInCompletionList("def foo(*args): pass\n"
+                                        "class Outer:\n"
+                                        "    def method(self):\n"
+                                        "        local_thing = 3\n"
+                                        "%INVOKE", completionCode, expectedDeclaration));
+}
+
+void PyCompletionTest::testMultiLineStatementInNestedScope_data()
+{
+    QTest::addColumn<QString>("completionCode");
+    QTest::addColumn<QString>("expectedDeclaration");
+
+    QTest::newRow("call") << "        foo(1,\n            2,\n            %CURSOR" << "local_thing";
+    QTest::newRow("initializer") << "        x = [1,\n             2,\n             %CURSOR" << "local_thing";
+    QTest::newRow("nested_call") << "        foo(1,\n            foo(2,\n                %CURSOR" << "local_thing";
+    QTest::newRow("member_in_call") << "        foo(1,\n            [].%CURSOR" << "append";
+}
+
 void PyCompletionTest::testIgnoreCommentSignsInStringLiterals()
 {
     QVERIFY( ! completionListIsEmpty("'#'%INVOKE", ".%CURSOR") );
@@ -477,6 +515,246 @@ void PyCompletionTest::testAutoBrackets()
     QCOMPARE(document->text(), QLatin1String("myprop"));
 }
 
+void PyCompletionTest::testCallableItemsDecidedLazily()
+{
+    QList< CompletionTreeItem* > items = invokeCompletionOn("def func(): pass\nclass Cls: pass\nvariable = 3\n%INVOKE",
+                                                            "%CURSOR");
+    KService::Ptr documentService = KService::serviceByDesktopPath("katepart.desktop");
+    QVERIFY(documentService);
+    const auto executed = [&](const QString& name) {
+        foreach ( CompletionTreeItem* ptr, items ) {
+            if ( ptr->declaration() && ptr->declaration()->identifier().toString() == name ) {
+                KTextEditor::Document* document = documentService->createInstance<KTextEditor::Document>(this);
+                ptr->execute(document->createView(nullptr), KTextEditor::Range(0, 0, 0, 0));
+                return document->text();
+            }
+        }
+        return QString();
+    };
+    // only functions and classes are completed with a call
+    QCOMPARE(executed("func"), QLatin1String("func()"));
+    QCOMPARE(executed("Cls"), QLatin1String("Cls()"));
+    QCOMPARE(executed("variable"), QLatin1String("variable"));
+}
+
+void PyCompletionTest::testTypedPrefixCompletion()
+{
+    const QString code = "abc_second = 1\nAbcUpper = 2\na_big_thing = 3\naaa_first = 4\nzzz = 5\n"
+                         "class foo:\n    abc_member = 6\n%INVOKE";
+    // the text following the cursor is what was typed of the word being completed
+    QList< CompletionTreeItem* > items = invokeCompletionOn(code, "%CURSORab");
+    QVERIFY(containsItemForDeclarationNamed(items, "abc_second"));
+    QVERIFY(containsItemForDeclarationNamed(items, "AbcUpper"));
+    QVERIFY(containsItemForDeclarationNamed(items, "a_big_thing"));
+    QVERIFY(containsItemForDeclarationNamed(items, "abs"));
+    QVERIFY(! containsItemForDeclarationNamed(items, "aaa_first"));
+    QVERIFY(! containsItemForDeclarationNamed(items, "zzz"));
+    QVERIFY(! containsItemForDeclarationNamed(items, "abc_member"));
+
+    items = invokeCompletionOn(code, "%CURSOR");
+    QVERIFY(containsItemForDeclarationNamed(items, "aaa_first"));
+    QVERIFY(containsItemForDeclarationNamed(items, "zzz"));
+    QVERIFY(! containsItemForDeclarationNamed(items, "abc_member"));
+}
+
+void PyCompletionTest::testManyPrefixMatchesKept()
+{
+    // more globals starting with "Q" than items are created for fuzzy matches
+    QString code;
+    for ( int i = 0; i < 600; i++ ) {
+        code += QString("QAbstract%1 = %1\n").arg(i);
+    }
+    code += "QWidget = 0\nseqs = 0\n%INVOKE";
+
+    // a name sorting after all the others must still be there, the editor narrows this list down for "QWi"
+    QList< CompletionTreeItem* > items = invokeCompletionOn(code, "%CURSORQ");
+    QVERIFY(containsItemForDeclarationNamed(items, "QWidget"));
+    QVERIFY(containsItemForDeclarationNamed(items, "QAbstract599"));
+    // names just containing a "q" are left out once there are enough prefix matches
+    QVERIFY(! containsItemForDeclarationNamed(items, "seqs"));
+}
+
+void PyCompletionTest::testAbbreviationMatchesKept()
+{
+    // more globals containing "g", "o" and "v" in order, and sorting first, than items are created for them
+    QString code;
+    for ( int i = 0; i < 600; i++ ) {
+        code += QString("agxoxv%1 = %1\n").arg(i);
+    }
+    code += "getOtherValue = 0\n%INVOKE";
+
+    // names whose words begin with what was typed are ranked first, and never left out
+    QList< CompletionTreeItem* > items = invokeCompletionOn(code, "%CURSORgOV");
+    QVERIFY(containsItemForDeclarationNamed(items, "getOtherValue"));
+    items = invokeCompletionOn(code, "%CURSORg");
+    QVERIFY(containsItemForDeclarationNamed(items, "getOtherValue"));
+    QVERIFY(! containsItemForDeclarationNamed(items, "agxoxv599"));
+}
+
+void PyCompletionTest::testLongMemberListNarrowed()
+{
+    QString code = "class C:\n    special_member = 0\n";
+    for ( int i = 0; i < 800; i++ ) {
+        code += QString("    member%1 = %1\n").arg(i);
+    }
+    code += "%INVOKE";
+    auto declarationItems = [](const QList<CompletionTreeItem*>& items) {
+        int count = 0;
+        foreach ( const CompletionTreeItem* item, items ) {
+            if ( item->declaration() ) {
+                count++;
+            }
+        }
+        return count;
+    };
+
+    // without anything typed, all members are offered
+    QList< CompletionTreeItem* > items = invokeCompletionOn(code, "C().%CURSOR");
+    QVERIFY(declarationItems(items) >= 801);
+
+    // otherwise only the best matches are turned into items
+    items = invokeCompletionOn(code, "C().%CURSORspe");
+    QVERIFY(containsItemForDeclarationNamed(items, "special_member"));
+    // names starting with what was typed, or with a word starting with it, are all kept, since the editor narrows
+    // this list down while typing continues; only names just containing the typed characters are left out
+    items = invokeCompletionOn(code, "C().%CURSORm");
+    QVERIFY(declarationItems(items) >= 801);
+    QVERIFY(containsItemForDeclarationNamed(items, "member799"));
+    QVERIFY(containsItemForDeclarationNamed(items, "special_member"));
+    items = invokeCompletionOn(code, "C().%CURSORe");
+    QVERIFY(! containsItemForDeclarationNamed(items, "special_member"));
+    items = invokeCompletionOn(code, "C().%CURSORmember79");
+    QVERIFY(containsItemForDeclarationNamed(items, "member799"));
+}
+
+void PyCompletionTest::testNarrowingReusesItems()
+{
+    PythonCodeCompletionModel model(this);
+    PythonCodeCompletionWorker worker(&model, QUrl());
+    CompletionParameters data = prepareCompletion("class C:\n    pattern = 0\n    path = 1\n    other = 2\n%INVOKE",
+                                                  "C().%CURSOR");
+    // the text following the cursor is what was typed of the word being completed
+    auto complete = [&](const QString& typed) {
+        PythonCodeCompletionContext* context = new PythonCodeCompletionContext(data.contextAtCursor, data.snip, typed,
+                                                                               data.cursorAt, 0, &worker);
+        bool abort = false;
+        QList<CompletionTreeItemPointer> items = context->completionItems(abort, true);
+        m_ptrs << items;
+        return items;
+    };
+
+    const QList<CompletionTreeItemPointer> first = complete("pa");
+    const QList<CompletionTreeItemPointer> narrowed = complete("pat");
+    QList<CompletionTreeItem*> narrowedItems;
+    foreach ( const CompletionTreeItemPointer& item, narrowed ) {
+        // the items of the previous request are reused
+        QVERIFY(first.contains(item));
+        narrowedItems << item.data();
+    }
+    QVERIFY(containsItemForDeclarationNamed(narrowedItems, "pattern"));
+    QVERIFY(containsItemForDeclarationNamed(narrowedItems, "path"));
+    QVERIFY(! containsItemForDeclarationNamed(narrowedItems, "other"));
+
+    // going back recomputes the items
+    const QList<CompletionTreeItemPointer> widened = complete("");
+    QVERIFY(! widened.isEmpty());
+    QVERIFY(! first.contains(widened.first()));
+}
+
+void PyCompletionTest::testUnionMemberItems()
+{
+    CompletionParameters data = prepareCompletion("class A:\n    shared = 0\n    only_a = 1\n"
+                                                  "class B:\n    shared = 2\n    only_b = 3\n"
+                                                  "x = A()\nx = B()\n%INVOKE", "x.%CURSOR");
+    auto namedItems = [](const QList<CompletionTreeItemPointer>& items, const QString& name) {
+        int count = 0;
+        foreach ( const CompletionTreeItemPointer& item, items ) {
+            if ( item->declaration() && item->declaration()->identifier().toString() == name ) {
+                count++;
+            }
+        }
+        return count;
+    };
+    auto complete = [&](bool fullCompletion) {
+        PythonCodeCompletionContext* context = new PythonCodeCompletionContext(data.contextAtCursor, data.snip,
+                                                                               data.remaining, data.cursorAt, 0, 0);
+        bool abort = false;
+        QList<CompletionTreeItemPointer> items = context->completionItems(abort, fullCompletion);
+        m_ptrs << items;
+        return items;
+    };
+
+    // members of both types are offered once
+    QList<CompletionTreeItemPointer> items = complete(false);
+    QCOMPARE(namedItems(items, "shared"), 1);
+    QCOMPARE(namedItems(items, "only_a"), 1);
+    QCOMPARE(namedItems(items, "only_b"), 1);
+
+    // unless all items are requested
+    items = complete(true);
+    QCOMPARE(namedItems(items, "shared"), 2);
+    QCOMPARE(namedItems(items, "only_a"), 1);
+}
+
+void PyCompletionTest::testCachedMemberList()
+{
+    makefile("memberlistbase.py", "class Base:\n    first = 1\n");
+    CompletionParameters data = prepareCompletion("from memberlistbase import Base\n"
+                                                  "class Derived(Base):\n    own = 0\n%INVOKE", "Derived().%CURSOR");
+    QList< CompletionTreeItem* > items = runCompletion(data);
+    QVERIFY(containsItemForDeclarationNamed(items, "own"));
+    QVERIFY(containsItemForDeclarationNamed(items, "first"));
+    // the second request is answered from the cache
+    items = runCompletion(data);
+    QVERIFY(containsItemForDeclarationNamed(items, "own"));
+    QVERIFY(containsItemForDeclarationNamed(items, "first"));
+
+    // changing a base class invalidates the cached members
+    makefile("memberlistbase.py", "class Base:\n    first = 1\n    second = 2\n");
+    items = runCompletion(data);
+    QVERIFY(containsItemForDeclarationNamed(items, "own"));
+    QVERIFY(containsItemForDeclarationNamed(items, "second"));
+}
+
+void PyCompletionTest::testCachedMemberListResolvedBase()
+{
+    CompletionParameters data = prepareCompletion("from memberlistlater import Later\n"
+                                                  "class Derived(Later):\n    own = 0\n%INVOKE", "Derived().%CURSOR");
+    QList< CompletionTreeItem* > items = runCompletion(data);
+    QVERIFY(containsItemForDeclarationNamed(items, "own"));
+    QVERIFY(! containsItemForDeclarationNamed(items, "inherited"));
+
+    // once the base class exists, the unmodified document is parsed again with the same revision
+    makefile("memberlistlater.py", "class Later:\n    inherited = 1\n");
+    reparseUnchanged(data.contextAtCursor);
+    QVERIFY(data.contextAtCursor);
+    items = runCompletion(data);
+    QVERIFY(containsItemForDeclarationNamed(items, "own"));
+    QVERIFY(containsItemForDeclarationNamed(items, "inherited"));
+}
+
+void PyCompletionTest::testCachedMemberListReparsed()
+{
+    CompletionParameters data = prepareCompletion("class C:\n    first = 0\n    second = 1\n"
+                                                  "    def third(self): pass\n%INVOKE", "C().%CURSOR");
+    QList< CompletionTreeItem* > items = runCompletion(data);
+    QVERIFY(containsItemForDeclarationNamed(items, "second"));
+
+    // the rebuild may replace some of the cached members, but none may be offered twice
+    reparseUnchanged(data.contextAtCursor);
+    QVERIFY(data.contextAtCursor);
+    items = runCompletion(data);
+    foreach ( const QString& name, QStringList{"first", "second", "third"} ) {
+        int found = 0;
+        foreach ( const CompletionTreeItem* item, items ) {
+            if ( item->declaration() && item->declaration()->identifier().toString() == name ) {
+                found++;
+            }
+        }
+        QCOMPARE(found, 1);
+    }
+}
+
 void PyCompletionTest::testExceptionCompletion()
 {
     QList< CompletionTreeItem* > items = invokeCompletionOn("localvar = 3\nraise %INVOKE", "%CURSOR");
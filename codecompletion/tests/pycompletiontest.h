@@ -62,11 +62,22 @@ class PyCompletionTest : public QObject
         void testIntegralTypesImmediate_data();
         void testIntegralExpressionsDifferentContexts();
         void testIntegralExpressionsDifferentContexts_data();
+        void testMultiLineStatementInNestedScope();
+        void testMultiLineStatementInNestedScope_data();
         void testNoCompletionInCommentsOrStrings();
         void testNoCompletionInCommentsOrStrings_data();
         void testImplementMethodCompletion();
         void testImplementMethodCompletion_data();
         void testExceptionCompletion();
+        void testTypedPrefixCompletion();
+        void testManyPrefixMatchesKept();
+        void testAbbreviationMatchesKept();
+        void testLongMemberListNarrowed();
+        void testNarrowingReusesItems();
+        void testUnionMemberItems();
+        void testCachedMemberList();
+        void testCachedMemberListResolvedBase();
+        void testCachedMemberListReparsed();
         void testGeneratorCompletion();
         void testInheritanceCompletion();
         void testImportCompletion();
@@ -80,6 +91,7 @@ class PyCompletionTest : public QObject
         void testIgnoreCommentSignsInStringLiterals();
         void testIdentifierMatching();
         void testAutoBrackets();
+        void testCallableItemsDecidedLazily();
         void testAddImportCompletion();
         void testAddImportCompletion_data();
         void testFunctionDeclarationCompletion();
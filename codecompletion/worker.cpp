@@ -22,6 +22,7 @@
 #include <language/duchain/declaration.h>
 #include <KLocalizedString>
 #include "codehelpers.h"
+#include "lexicalstatecache.h"
 #include <KTextEditor/View>
 
 #include <QDebug>
@@ -51,6 +52,11 @@ KDevelop::CodeCompletionContext* PythonCodeCompletionWorker::createCompletionCon
     return completionContext;
 }
 
+CompletionResultCache& PythonCodeCompletionWorker::resultCache() const
+{
+    return m_resultCache;
+}
+
 void PythonCodeCompletionWorker::updateContextRange(KTextEditor::Range &contextRange, KTextEditor::View *view, KDevelop::DUContextPointer context) const
 {
     if ( ! context ) {
@@ -59,7 +65,8 @@ void PythonCodeCompletionWorker::updateContextRange(KTextEditor::Range &contextR
     if ( ! contextRange.start().isValid() ) {
         contextRange.setStart({0, 0});
     }
-    if ( CodeHelpers::endsInside(view->document()->text(contextRange)) == CodeHelpers::String ) {
+    const QString text = view->document()->text(contextRange);
+    if ( LexicalStateCache::state(view->document()->url().toString(), text).endLocation() == CodeHelpers::String ) {
         qCDebug(KDEV_PYTHON_CODECOMPLETION) << "we're dealing with string completion. extend the range";
         contextRange = context->rangeInCurrentRevision();
     }
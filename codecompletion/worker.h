@@ -23,6 +23,7 @@
 #include <language/codecompletion/codecompletionworker.h>
 #include <language/codecompletion/codecompletionitem.h>
 #include "pythoncompletionexport.h"
+#include "resultcache.h"
 
 namespace Python {
 
@@ -34,7 +35,12 @@ public:
     PythonCodeCompletionWorker(PythonCodeCompletionModel *parent, const QUrl& document);
     KDevelop::CodeCompletionContext* createCompletionContext(KDevelop::DUContextPointer context, const QString& contextText, const QString& followingText, const KDevelop::CursorInRevision& position) const override;
     void updateContextRange(KTextEditor::Range &contextRange, KTextEditor::View *view, KDevelop::DUContextPointer context) const override;
+    /// Items of the last request, for narrowing them down on the next one.
+    CompletionResultCache& resultCache() const;
     PythonCodeCompletionModel* parent;
+
+private:
+    mutable CompletionResultCache m_resultCache;
 };
 
 }
@@ -35,6 +35,7 @@
 #include <KTextEditor/Document>
 
 #include "duchain/helpers.h"
+#include "duchain/correctionfileindex.h"
 #include "parser/codehelpers.h"
 
 #include <QDebug>
@@ -368,6 +369,8 @@ void CorrectionFileGenerator::addHint(const QString &typeCode, const QStringList
 
         if ( success && m_file.open(QFile::ReadWrite) ) {
             qCDebug(KDEV_PYTHON_CODEGEN) << "Successfully saved correction file.";
+            // the file or even its directory might be new, which a file watcher does not reliably catch
+            CorrectionFileIndex::self()->invalidate();
 
             m_oldContents = m_code;
         }
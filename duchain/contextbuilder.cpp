@@ -28,6 +28,7 @@
 #include "declarationbuilder.h"
 #include "helpers.h"
 #include "duchaindebug.h"
+#include "timedlocker.h"
 
 #include <ktexteditor/document.h>
 
@@ -37,6 +38,7 @@
 #include <language/duchain/topducontext.h>
 #include <language/duchain/parsingenvironment.h>
 #include <language/backgroundparser/backgroundparser.h>
+#include <language/backgroundparser/parsejob.h>
 #include <language/editor/rangeinrevision.h>
 #include <language/editor/cursorinrevision.h>
 #include <interfaces/icore.h>
@@ -56,7 +58,7 @@ namespace Python
 ReferencedTopDUContext ContextBuilder::build(const IndexedString& url, Ast* node, ReferencedTopDUContext updateContext)
 {
     if (!updateContext) {
-        DUChainReadLocker lock(DUChain::lock());
+        TimedDUChainReadLocker lock("DUChain read lock (ContextBuilder)");
         updateContext = DUChain::self()->chainForDocument(url);
         if ( updateContext ) {
             Q_ASSERT(updateContext->type() == DUContext::Global);
@@ -64,7 +66,7 @@ ReferencedTopDUContext ContextBuilder::build(const IndexedString& url, Ast* node
     }
     if (updateContext) {
         qDebug() << " ====> DUCHAIN ====>     rebuilding duchain for" << url.str() << "(was built before)";
-        DUChainWriteLocker lock(DUChain::lock());
+        TimedDUChainWriteLocker lock("DUChain write lock (ContextBuilder::build)");
         Q_ASSERT(updateContext->type() == DUContext::Global);
         updateContext->clearImportedParentContexts();
         updateContext->parsingEnvironmentFile()->clearModificationRevisions();
@@ -80,6 +82,36 @@ PythonEditorIntegrator* ContextBuilder::editor() const
     return m_editor;
 }
 
+void ContextBuilder::setParseJob(const KDevelop::ParseJob* job)
+{
+    m_parseJob = job;
+}
+
+bool ContextBuilder::wasAborted() const
+{
+    return m_aborted;
+}
+
+bool ContextBuilder::checkAborted()
+{
+    if ( ! m_aborted && m_parseJob && m_parseJob->abortRequested() ) {
+        qCDebug(KDEV_PYTHON_DUCHAIN) << "parse job was aborted, stopping to build" << currentlyParsedDocument().str();
+        m_aborted = true;
+    }
+    return m_aborted;
+}
+
+void ContextBuilder::visitNode(Ast* node)
+{
+    // Skipping the remaining nodes still closes all open contexts properly, since those are
+    // opened and closed around the visiting of their children.
+    // The job is only asked every few nodes, asking for every node would be needlessly slow.
+    if ( m_aborted || ( ++m_visitedNodes % 256 == 0 && checkAborted() ) ) {
+        return;
+    }
+    AstDefaultVisitor::visitNode(node);
+}
+
 IndexedString ContextBuilder::currentlyParsedDocument() const
 {
     return m_currentlyParsedDocument;
@@ -133,6 +165,18 @@ QList<IndexedString> ContextBuilder::unresolvedImports() const
     return m_unresolvedImports;
 }
 
+void ContextBuilder::reportProblem(const ProblemPointer& problem)
+{
+    m_reportedProblems.append(problem);
+}
+
+QVector<ProblemPointer> ContextBuilder::takeReportedProblems()
+{
+    QVector<ProblemPointer> problems;
+    problems.swap(m_reportedProblems);
+    return problems;
+}
+
 void ContextBuilder::setEditor(PythonEditorIntegrator* editor)
 {
     m_editor = editor;
@@ -179,7 +223,7 @@ void ContextBuilder::addImportedContexts()
 {
     if ( compilingContexts() && !m_importedParentContexts.isEmpty() )
     {
-        DUChainWriteLocker lock( DUChain::lock() );
+        TimedDUChainWriteLocker lock("DUChain write lock (ContextBuilder)");
         foreach( DUContext* imported, m_importedParentContexts )
             currentContext()->addImportedParentContext( imported );
 
@@ -251,7 +295,7 @@ void ContextBuilder::visitComprehensionCommon(Ast* node)
     RangeInRevision range = comprehensionRange(node);
     Q_ASSERT(range.isValid());
     if ( range.isValid() ) {
-        DUChainWriteLocker lock;
+        TimedDUChainWriteLocker lock("DUChain write lock (ContextBuilder)");
         openContext(node, range, KDevelop::DUContext::Other);
         qCDebug(KDEV_PYTHON_DUCHAIN) << "creating comprehension context" << node << range;
         Q_ASSERT(currentContext());
@@ -280,7 +324,7 @@ void ContextBuilder::openContextForClassDefinition(ClassDefinitionAst* node)
         start = CursorInRevision(node->startLine + 1, 0);
     }
     RangeInRevision range(start, CursorInRevision(endLine + 1, 0));
-    DUChainWriteLocker lock;
+    TimedDUChainWriteLocker lock("DUChain write lock (ContextBuilder)");
     openContext(node, range, DUContext::Class, node->name);
     currentContext()->setLocalScopeIdentifier(identifierForNode(node->name));
     lock.unlock();
@@ -312,7 +356,7 @@ void ContextBuilder::visitCode(CodeAst* node) {
             // KDevelop::ICore::self()->languageController()->backgroundParser()->parseDocuments();
         }
         else {
-            DUChainWriteLocker wlock;
+            TimedDUChainWriteLocker wlock("DUChain write lock (ContextBuilder)");
             currentContext()->addImportedParentContext(internal);
         }
     }
@@ -451,6 +495,7 @@ void ContextBuilder::visitFunctionDefinition(FunctionDefinitionAst* node)
 
 void ContextBuilder::visitFunctionBody(FunctionDefinitionAst* node)
 {
+    checkAborted();
     // The function should end at the next DEDENT token, not at the body's last statement
     int endLine = node->endLine;
     if ( ! node->body.isEmpty() ) {
@@ -473,7 +518,7 @@ void ContextBuilder::visitFunctionBody(FunctionDefinitionAst* node)
     // It's of type Other, as it contains only code
     openContext(node, range, DUContext::Other, identifierForNode(node->name));
     {
-        DUChainWriteLocker lock;
+        TimedDUChainWriteLocker lock("DUChain write lock (ContextBuilder)");
         currentContext()->setLocalScopeIdentifier(identifierForNode(node->name));
     }
     // import the parameters into the function body
@@ -25,11 +25,18 @@
 #include <language/duchain/builders/abstractcontextbuilder.h>
 #include <language/editor/rangeinrevision.h>
 #include <language/duchain/topducontext.h>
+#include <language/duchain/problem.h>
+
+#include <QVector>
 
 #include "pythonduchainexport.h"
 
 using namespace KDevelop;
 
+namespace KDevelop {
+class ParseJob;
+}
+
 namespace Python
 {
 
@@ -70,6 +77,18 @@ public:
      */
     PythonEditorIntegrator* editor() const;
 
+    /**
+     * @brief Set the parse job this builder runs in.
+     * The builder regularly checks whether the job was aborted, and if so, stops visiting the tree.
+     */
+    void setParseJob(const KDevelop::ParseJob* job);
+
+    /**
+     * @brief Whether building was stopped early because the parse job was aborted.
+     * The resulting context is incomplete in that case, and must be rebuilt before it is used.
+     */
+    bool wasAborted() const;
+
     /**
      * @brief Find the URL which would be imported by the dotted name @p name.
      *
@@ -114,6 +133,19 @@ public:
      */
     QList<IndexedString> unresolvedImports() const;
 
+    /**
+     * @brief Queue @p problem to be added to the top context once building has finished.
+     *
+     * This does not require the DUChain lock; call takeReportedProblems() to collect the problems
+     * and add them to the top context in the job's final write-locked phase.
+     */
+    void reportProblem(const ProblemPointer& problem);
+
+    /**
+     * @brief Retrieve (and forget) all problems queued by reportProblem().
+     */
+    QVector<ProblemPointer> takeReportedProblems();
+
 public:
     // ugly because this collides with currentDocument(), but we have to use it;
     // for some reason the UseBuilder does not have m_url set, and it's private (not even protected) to AbstractContextBuilder.
@@ -148,6 +180,7 @@ protected:
     void visitComprehensionCommon(Ast* node);
 
     virtual void startVisiting(Ast* node);
+    void visitNode(Ast* node) override;
     virtual KDevelop::RangeInRevision editorFindRange(Ast* fromNode, Ast* toNode);
     virtual KDevelop::CursorInRevision editorFindPositionSafe(Ast* node);
     virtual KDevelop::CursorInRevision startPos(Ast* node);
@@ -174,6 +207,11 @@ protected:
     virtual void visitFunctionBody(FunctionDefinitionAst* node);
     void openContextForClassDefinition(ClassDefinitionAst* node);
 
+    /**
+     * @brief Check whether the parse job was aborted; once it was, no more nodes are visited.
+     */
+    bool checkAborted();
+
     template <typename T> void visitNodeList( const QList<T*>& l ) {
         foreach ( T* node, l ) {
             visitNode(node);
@@ -197,9 +235,17 @@ protected:
     // true if the first of the two performed passes is currently active
     bool m_prebuilding = false;
 
+    // The job this builder runs in, checked for abort requests while visiting
+    const KDevelop::ParseJob* m_parseJob = nullptr;
+    bool m_aborted = false;
+    uint m_visitedNodes = 0;
+
     // List of imports which were encountered, but could not be resolved
     QList<IndexedString> m_unresolvedImports;
 
+    // Problems found while building, not yet added to the top context
+    QVector<ProblemPointer> m_reportedProblems;
+
     // The ModificationRevision this context will be valid for
     ModificationRevision m_futureModificationRevision;
 
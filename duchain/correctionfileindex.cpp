@@ -0,0 +1,136 @@
+/*****************************************************************************
+ * This file is part of KDevelop                                             *
+ * Copyright 2026 agent <agent@local>                                        *
+ *                                                                           *
+ * This program is free software; you can redistribute it and/or             *
+ * modify it under the terms of the GNU General Public License as            *
+ * published by the Free Software Foundation; either version 2 of            *
+ * the License, or (at your option) any later version.                       *
+ *                                                                           *
+ * This program is distributed in the hope that it will be useful,           *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the             *
+ * GNU General Public License for more details.                              *
+ *                                                                           *
+ * You should have received a copy of the GNU General Public License         *
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.     *
+ *****************************************************************************
+ */
+
+#include "correctionfileindex.h"
+
+#include <QDir>
+#include <QDirIterator>
+#include <QFileInfo>
+#include <QFileSystemWatcher>
+#include <QStandardPaths>
+
+#include <QDebug>
+#include "duchaindebug.h"
+
+namespace Python
+{
+
+CorrectionFileIndex* CorrectionFileIndex::self()
+{
+    static CorrectionFileIndex* index = new CorrectionFileIndex();
+    return index;
+}
+
+CorrectionFileIndex::CorrectionFileIndex()
+    : m_watcher(new QFileSystemWatcher(this))
+{
+    auto markDirty = [this]() {
+        QWriteLocker lock(&m_lock);
+        m_dirty = true;
+    };
+    connect(m_watcher, &QFileSystemWatcher::directoryChanged, this, markDirty);
+    // the watcher lives in the thread the index was created in, while rebuilding can happen in any thread
+    connect(this, &CorrectionFileIndex::indexedDirectoriesChanged, this, [this](const QStringList& directories) {
+        const auto watched = m_watcher->directories();
+        if ( ! watched.isEmpty() ) {
+            m_watcher->removePaths(watched);
+        }
+        if ( ! directories.isEmpty() ) {
+            m_watcher->addPaths(directories);
+        }
+    }, Qt::QueuedConnection);
+}
+
+void CorrectionFileIndex::invalidate()
+{
+    QWriteLocker lock(&m_lock);
+    m_dirty = true;
+}
+
+void CorrectionFileIndex::ensureUpToDate()
+{
+    {
+        QReadLocker lock(&m_lock);
+        if ( ! m_dirty ) {
+            return;
+        }
+    }
+    QWriteLocker lock(&m_lock);
+    if ( m_dirty ) {
+        rebuild();
+        m_dirty = false;
+    }
+}
+
+void CorrectionFileIndex::rebuild()
+{
+    m_files.clear();
+    m_fileNames.clear();
+    QStringList watchedDirectories;
+    const auto correctionFileDirs = QStandardPaths::locateAll(QStandardPaths::GenericDataLocation,
+                                                              "kdevpythonsupport/correction_files/",
+                                                              QStandardPaths::LocateDirectory);
+    foreach ( const QString& dir, correctionFileDirs ) {
+        const QDir base(dir);
+        QHash<QString, QString> files;
+        watchedDirectories.append(base.absolutePath());
+        QDirIterator it(dir, QDir::Files | QDir::Dirs | QDir::NoDotAndDotDot, QDirIterator::Subdirectories);
+        while ( it.hasNext() ) {
+            const QString path = it.next();
+            const QFileInfo info = it.fileInfo();
+            if ( info.isDir() ) {
+                watchedDirectories.append(info.absoluteFilePath());
+                continue;
+            }
+            files.insert(QDir::cleanPath(base.relativeFilePath(path)), QDir::cleanPath(info.absoluteFilePath()));
+            m_fileNames.insert(info.fileName());
+        }
+        m_files.append(files);
+    }
+    emit indexedDirectoriesChanged(watchedDirectories);
+    qCDebug(KDEV_PYTHON_DUCHAIN) << "indexed" << m_fileNames.size() << "correction file names in" << correctionFileDirs;
+}
+
+bool CorrectionFileIndex::mightHaveCorrectionFile(const QUrl& document)
+{
+    ensureUpToDate();
+    QReadLocker lock(&m_lock);
+    return m_fileNames.contains(document.fileName());
+}
+
+QUrl CorrectionFileIndex::correctionFile(const QUrl& document, const QList<QUrl>& searchPaths)
+{
+    ensureUpToDate();
+    QReadLocker lock(&m_lock);
+    foreach ( const auto& files, m_files ) {
+        foreach ( const QUrl& basePath, searchPaths ) {
+            if ( ! basePath.isParentOf(document) ) {
+                continue;
+            }
+            const auto relative = QDir::cleanPath(QDir(basePath.path()).relativeFilePath(document.path()));
+            const auto it = files.constFind(relative);
+            if ( it != files.constEnd() ) {
+                return QUrl::fromLocalFile(it.value());
+            }
+        }
+    }
+    return {};
+}
+
+}
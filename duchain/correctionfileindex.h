@@ -0,0 +1,87 @@
+/*****************************************************************************
+ * This file is part of KDevelop                                             *
+ * Copyright 2026 agent <agent@local>                                        *
+ *                                                                           *
+ * This program is free software; you can redistribute it and/or             *
+ * modify it under the terms of the GNU General Public License as            *
+ * published by the Free Software Foundation; either version 2 of            *
+ * the License, or (at your option) any later version.                       *
+ *                                                                           *
+ * This program is distributed in the hope that it will be useful,           *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the             *
+ * GNU General Public License for more details.                              *
+ *                                                                           *
+ * You should have received a copy of the GNU General Public License         *
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.     *
+ *****************************************************************************
+ */
+
+#ifndef PYTHON_CORRECTIONFILEINDEX_H
+#define PYTHON_CORRECTIONFILEINDEX_H
+
+#include <QHash>
+#include <QObject>
+#include <QReadWriteLock>
+#include <QSet>
+#include <QStringList>
+#include <QUrl>
+#include <QVector>
+
+#include "pythonduchainexport.h"
+
+class QFileSystemWatcher;
+
+namespace Python
+{
+
+/**
+ * @brief In-memory list of all correction files, so finding the one for a document does not need to touch the disk.
+ *
+ * The index is built on first use, and rebuilt on the next lookup after a watched correction file
+ * directory changed, or after invalidate() was called. It should be created on the main thread
+ * (by calling self() there once), so the file system watcher can deliver its notifications.
+ */
+class KDEVPYTHONDUCHAIN_EXPORT CorrectionFileIndex : public QObject
+{
+    Q_OBJECT
+public:
+    static CorrectionFileIndex* self();
+
+    /**
+     * @brief Quick check whether any correction file has the same file name as @p document.
+     * If this returns false, there is no correction file for @p document.
+     */
+    bool mightHaveCorrectionFile(const QUrl& document);
+
+    /**
+     * @brief Find the correction file for @p document, which is looked up relative to each of the @p searchPaths.
+     * @return the correction file's URL, or an empty URL if there is none
+     */
+    QUrl correctionFile(const QUrl& document, const QList<QUrl>& searchPaths);
+
+    /**
+     * @brief Rebuild the index before the next lookup; call this after writing correction files.
+     */
+    void invalidate();
+
+signals:
+    void indexedDirectoriesChanged(const QStringList& directories);
+
+private:
+    CorrectionFileIndex();
+    void ensureUpToDate();
+    // must be called with m_lock locked for writing
+    void rebuild();
+
+    QReadWriteLock m_lock;
+    bool m_dirty = true;
+    // relative path -> absolute path, one entry per correction file directory in lookup order
+    QVector<QHash<QString, QString>> m_files;
+    QSet<QString> m_fileNames;
+    QFileSystemWatcher* m_watcher;
+};
+
+}
+
+#endif // PYTHON_CORRECTIONFILEINDEX_H
@@ -32,6 +32,8 @@
 #include "helpers.h"
 #include "assistants/missingincludeassistant.h"
 #include "correctionhelper.h"
+#include "parseprofiler.h"
+#include "timedlocker.h"
 
 #include <language/duchain/functiondeclaration.h>
 #include <language/duchain/declaration.h>
@@ -60,6 +62,28 @@ using namespace KDevelop;
 namespace Python
 {
 
+namespace {
+/// Collects all dotted names (such as "os.path.join", and "os.path") which are accessed in a syntax tree
+class AttributeChainCollector : public AstDefaultVisitor
+{
+public:
+    void visitAttribute(AttributeAst* node) override {
+        QStringList components{node->attribute->value};
+        ExpressionAst* value = node->value;
+        while ( value && value->astType == Ast::AttributeAstType ) {
+            components.prepend(static_cast<AttributeAst*>(value)->attribute->value);
+            value = static_cast<AttributeAst*>(value)->value;
+        }
+        if ( value && value->astType == Ast::NameAstType ) {
+            components.prepend(static_cast<NameAst*>(value)->identifier->value);
+            chains.insert(components.join('.'));
+        }
+        AstDefaultVisitor::visitAttribute(node);
+    }
+    QSet<QString> chains;
+};
+}
+
 DeclarationBuilder::DeclarationBuilder(Python::PythonEditorIntegrator* editor, int ownPriority)
     : DeclarationBuilderBase()
     , m_ownPriority(ownPriority)
@@ -71,7 +95,7 @@ DeclarationBuilder::DeclarationBuilder(Python::PythonEditorIntegrator* editor, i
 DeclarationBuilder:: ~DeclarationBuilder()
 {
     if ( ! m_scheduledForDeletion.isEmpty() ) {
-        DUChainWriteLocker lock;
+        TimedDUChainWriteLocker lock("DUChain write lock (DeclarationBuilder)");
         foreach ( DUChainBase* d, m_scheduledForDeletion ) {
             delete d;
         }
@@ -88,22 +112,39 @@ ReferencedTopDUContext DeclarationBuilder::build(const IndexedString& url, Ast*
 {
     m_correctionHelper.reset(new CorrectionHelper(url, this));
 
+    if ( ! m_prebuilding ) {
+        AttributeChainCollector collector;
+        collector.visitNode(node);
+        m_accessedAttributeChains = collector.chains;
+    }
+
     // The declaration builder needs to run twice, so it can resolve uses of e.g. functions
     // which are called before they are defined (which is easily possible, due to python's dynamic nature).
     if ( ! m_prebuilding ) {
         qCDebug(KDEV_PYTHON_DUCHAIN) << "building, but running pre-builder first";
         DeclarationBuilder* prebuilder = new DeclarationBuilder(editor());
         prebuilder->m_ownPriority = m_ownPriority;
+        prebuilder->m_accessedAttributeChains = m_accessedAttributeChains;
         prebuilder->m_currentlyParsedDocument = currentlyParsedDocument();
         prebuilder->setPrebuilding(true);
         prebuilder->m_futureModificationRevision = m_futureModificationRevision;
-        updateContext = prebuilder->build(url, node, updateContext);
+        prebuilder->m_parseJob = m_parseJob;
+        {
+            ParseProfilerScope profile(url.str(), ParseProfiler::Prebuild);
+            updateContext = prebuilder->build(url, node, updateContext);
+        }
         qCDebug(KDEV_PYTHON_DUCHAIN) << "pre-builder finished";
+        m_aborted = prebuilder->wasAborted();
         delete prebuilder;
+        if ( m_aborted ) {
+            return updateContext;
+        }
     }
     else {
         qCDebug(KDEV_PYTHON_DUCHAIN) << "prebuilding";
+        return DeclarationBuilderBase::build(url, node, updateContext);
     }
+    ParseProfilerScope profile(url.str(), ParseProfiler::DeclarationBuild);
     return DeclarationBuilderBase::build(url, node, updateContext);
 }
 
@@ -115,7 +156,7 @@ int DeclarationBuilder::jobPriority() const
 void DeclarationBuilder::closeDeclaration()
 {
     if ( lastContext() ) {
-        DUChainReadLocker lock(DUChain::lock());
+        TimedDUChainReadLocker lock("DUChain read lock (DeclarationBuilder)");
         currentDeclaration()->setKind(Declaration::Type);
     }
     
@@ -253,7 +294,7 @@ typedef QPair<Declaration*, int> p;
 template<typename T> T* DeclarationBuilder::visitVariableDeclaration(Identifier* node, Ast* originalAst, Declaration* previous,
                                                                      AbstractType::Ptr type, VisitVariableFlags flags)
 {
-    DUChainWriteLocker lock;
+    TimedDUChainWriteLocker lock("DUChain write lock (DeclarationBuilder)");
     Ast* rangeNode = originalAst ? originalAst : node;
     RangeInRevision range = editorFindRange(rangeNode, rangeNode);
     
@@ -291,7 +332,7 @@ template<typename T> T* DeclarationBuilder::visitVariableDeclaration(Identifier*
     bool haveFittingDeclaration = false;
     if ( ! existingDeclarations.isEmpty() && existingDeclarations.last() ) {
         Declaration* d = Helper::resolveAliasDeclaration(existingDeclarations.last());
-        DUChainReadLocker lock;
+        TimedDUChainReadLocker lock("DUChain read lock (DeclarationBuilder)");
         if ( d && d->topContext() != topContext() ) {
             inSameTopContext = false;
         }
@@ -471,7 +512,7 @@ void DeclarationBuilder::visitFor(ForAst* node)
 
 Declaration* DeclarationBuilder::findDeclarationInContext(QStringList dottedNameIdentifier, TopDUContext* ctx) const
 {
-    DUChainReadLocker lock(DUChain::lock());
+    TimedDUChainReadLocker lock("DUChain read lock (DeclarationBuilder)");
     DUContext* currentContext = ctx;
     // TODO make this a bit faster, it wastes time
     Declaration* lastAccessedDeclaration = 0;
@@ -543,8 +584,7 @@ void DeclarationBuilder::visitImportFrom(ImportFromAst* node)
             success = createModuleImportDeclaration(moduleName, declarationName, declarationIdentifier, problem_init);
         }
         if ( ! success && problem ) {
-            DUChainWriteLocker lock;
-            topContext()->addProblem(problem);
+            reportProblem(problem);
         }
     }
 }
@@ -589,7 +629,6 @@ void DeclarationBuilder::visitComprehension(ComprehensionAst* node)
 void DeclarationBuilder::visitImport(ImportAst* node)
 {
     Python::ContextBuilder::visitImport(node);
-    DUChainWriteLocker lock;
     foreach ( AliasAst* name, node->names ) {
         QString moduleName = name->name->value;
         // use alias if available, name otherwise
@@ -597,8 +636,7 @@ void DeclarationBuilder::visitImport(ImportAst* node)
         ProblemPointer problem(0);
         createModuleImportDeclaration(moduleName, declarationIdentifier->value, declarationIdentifier, problem);
         if ( problem ) {
-            DUChainWriteLocker lock;
-            topContext()->addProblem(problem);
+            reportProblem(problem);
         }
     }
 }
@@ -671,7 +709,7 @@ Declaration* DeclarationBuilder::createDeclarationTree(const QStringList& nameCo
     
     RangeInRevision displayRange = RangeInRevision::invalid();
     
-    DUChainWriteLocker lock;
+    TimedDUChainWriteLocker lock("DUChain write lock (DeclarationBuilder)");
     for ( int i = 0; i < remainingNameComponents.length(); i++ ) {
         // Iterate over all the names, and create a declaration + sub-context for each of them
         const QString& component = remainingNameComponents.at(i);
@@ -785,6 +823,31 @@ Declaration* DeclarationBuilder::createDeclarationTree(const QStringList& nameCo
     else return 0;
 }
 
+void DeclarationBuilder::declareSubmodulePlaceholders(Declaration* package, const QStringList& submodules,
+                                                      Identifier* declarationIdentifier)
+{
+    DUContext* packageContext = nullptr;
+    {
+        TimedDUChainReadLocker lock("DUChain read lock (DeclarationBuilder)");
+        packageContext = package->internalContext();
+    }
+    if ( submodules.isEmpty() || ! packageContext ) {
+        return;
+    }
+    injectContext(packageContext);
+    // declare all of them under one lock, there can be hundreds
+    TimedDUChainWriteLocker lock("DUChain write lock (DeclarationBuilder)");
+    const RangeInRevision range(packageContext->range().start, packageContext->range().start);
+    foreach ( const QString& submodule, submodules ) {
+        Identifier id(submodule);
+        id.copyRange(declarationIdentifier);
+        if ( Declaration* d = visitVariableDeclaration<Declaration>(&id, range) ) {
+            d->setAutoDeclaration(true);
+        }
+    }
+    closeInjectedContext();
+}
+
 Declaration* DeclarationBuilder::createModuleImportDeclaration(QString moduleName, QString declarationName,
                                                                Identifier* declarationIdentifier,
                                                                ProblemPointer& problemEncountered, Ast* rangeNode)
@@ -802,10 +865,12 @@ Declaration* DeclarationBuilder::createModuleImportDeclaration(QString moduleNam
     
     qCDebug(KDEV_PYTHON_DUCHAIN) << "Found module path [path/path in file]: " << moduleInfo;
     qCDebug(KDEV_PYTHON_DUCHAIN) << "Declaration identifier:" << declarationIdentifier->value;
-    DUChainWriteLocker lock;
     const IndexedString modulePath = IndexedString(moduleInfo.first);
-    ReferencedTopDUContext moduleContext = DUChain::self()->chainForDocument(modulePath);
-    lock.unlock();
+    ReferencedTopDUContext moduleContext;
+    {
+        TimedDUChainReadLocker lock("DUChain read lock (DeclarationBuilder)");
+        moduleContext = DUChain::self()->chainForDocument(modulePath);
+    }
     Declaration* resultingDeclaration = 0;
     if ( ! moduleInfo.first.isValid() ) {
         // The file was not found -- this is either an error in the user's code,
@@ -837,22 +902,45 @@ Declaration* DeclarationBuilder::createModuleImportDeclaration(QString moduleNam
         auto initFile = QStringLiteral("/__init__.py");
         auto path = moduleInfo.first.path();
         if ( path.endsWith(initFile) ) {
-            // if the __init__ file is imported, import all the other files in that directory as well
+            // If the __init__ file is imported, the other files in that directory are accessible as attributes
+            // of the package as well. Only resolve (and, if necessary, parse) those which are actually accessed
+            // in this document, to not flood the parser with every file of large packages; the others get
+            // a placeholder declaration, so they are still offered in completion.
             QDir dir(path.left(path.size() - initFile.size()));
             dir.setNameFilters({"*.py"});
             dir.setFilter(QDir::Files);
-            auto files = dir.entryList();
-            foreach ( const auto& file, files ) {
+            QStringList files;
+            QStringList placeholders;
+            foreach ( const auto& file, dir.entryList() ) {
                 if ( file == QStringLiteral("__init__.py") ) {
                     continue;
                 }
+                const auto submodule = file.left(file.lastIndexOf(".py"));
+                if ( m_accessedAttributeChains.contains(declarationName + "." + submodule) ) {
+                    files.append(file);
+                }
+                else {
+                    placeholders.append(submodule);
+                }
+            }
+            if ( resultingDeclaration ) {
+                declareSubmodulePlaceholders(resultingDeclaration, placeholders, declarationIdentifier);
+            }
+            // look up all sibling modules at once, instead of locking the duchain for each of them
+            QVector<ReferencedTopDUContext> fileContexts;
+            fileContexts.reserve(files.size());
+            {
+                TimedDUChainReadLocker lock("DUChain read lock (DeclarationBuilder)");
+                foreach ( const auto& file, files ) {
+                    const auto fileUrl = QUrl::fromLocalFile(dir.path() + "/" + file);
+                    fileContexts.append(DUChain::self()->chainForDocument(IndexedString(fileUrl)));
+                }
+            }
+            for ( int i = 0; i < files.size(); i++ ) {
+                const auto& file = files.at(i);
                 const auto filePath = declarationName.split(".") << file.left(file.lastIndexOf(".py"));
                 const auto fileUrl = QUrl::fromLocalFile(dir.path() + "/" + file);
-                ReferencedTopDUContext fileContext;
-                {
-                    DUChainReadLocker lock;
-                    fileContext = DUChain::self()->chainForDocument(IndexedString(fileUrl));
-                }
+                const ReferencedTopDUContext& fileContext = fileContexts.at(i);
                 if ( fileContext ) {
                     Identifier id = *declarationIdentifier;
                     id.value.append(".").append(filePath.last());
@@ -868,7 +956,7 @@ Declaration* DeclarationBuilder::createModuleImportDeclaration(QString moduleNam
     }
     else {
         // import a specific declaration from the given file
-        lock.lock();
+        TimedDUChainWriteLocker lock("DUChain write lock (DeclarationBuilder)");
         if ( declarationIdentifier->value == "*" ) {
             qCDebug(KDEV_PYTHON_DUCHAIN) << "Importing * from module";
             currentContext()->addImportedParentContext(moduleContext);
@@ -877,7 +965,6 @@ Declaration* DeclarationBuilder::createModuleImportDeclaration(QString moduleNam
             qCDebug(KDEV_PYTHON_DUCHAIN) << "Got module, importing declaration: " << moduleInfo.second;
             Declaration* originalDeclaration = findDeclarationInContext(moduleInfo.second, moduleContext);
             if ( originalDeclaration ) {
-                DUChainWriteLocker lock(DUChain::lock());
                 resultingDeclaration = createDeclarationTree(declarationName.split("."), declarationIdentifier,
                                                              ReferencedTopDUContext(0), originalDeclaration,
                                                              editorFindRange(declarationIdentifier, declarationIdentifier));
@@ -924,7 +1011,7 @@ void DeclarationBuilder::visitYield(YieldAst* node)
     }
     else {
         // Otherwise, create a new container type, and set it as the function's return type.
-        DUChainWriteLocker lock;
+        TimedDUChainWriteLocker lock("DUChain write lock (DeclarationBuilder)");
         auto container = ExpressionVisitor::typeObjectForIntegralType<ListType>("list");
         if ( container ) {
             openType<ListType>(container);
@@ -938,7 +1025,7 @@ void DeclarationBuilder::visitYield(YieldAst* node)
 void DeclarationBuilder::visitLambda(LambdaAst* node)
 {
     Python::AstDefaultVisitor::visitLambda(node);
-    DUChainWriteLocker lock;
+    TimedDUChainWriteLocker lock("DUChain write lock (DeclarationBuilder)");
     // A context must be opened, because the lamdba's arguments are local to the lambda:
     // d = lambda x: x*2; print x # <- gives an error
     openContext(node, editorFindRange(node, node->body), DUContext::Other);
@@ -977,7 +1064,7 @@ void DeclarationBuilder::applyDocstringHints(CallAst* node, FunctionDeclaration:
         if ( ! argVisitor.lastType() ) {
             return;
         }
-        DUChainWriteLocker wlock;
+        TimedDUChainWriteLocker wlock("DUChain write lock (DeclarationBuilder)");
         qCDebug(KDEV_PYTHON_DUCHAIN) << "Adding content type: " << argVisitor.lastType()->toString();
         container->addContentType<Python::UnsureType>(argVisitor.lastType());
         v.lastDeclaration()->setType(container);
@@ -989,7 +1076,7 @@ void DeclarationBuilder::applyDocstringHints(CallAst* node, FunctionDeclaration:
         }
         ExpressionVisitor argVisitor(currentContext());
         argVisitor.visitNode(node->arguments.at(offset));
-        DUChainWriteLocker wlock;
+        TimedDUChainWriteLocker wlock("DUChain write lock (DeclarationBuilder)");
         if ( ! argVisitor.lastType() ) {
             return;
         }
@@ -1016,7 +1103,7 @@ void DeclarationBuilder::applyDocstringHints(CallAst* node, FunctionDeclaration:
 
 void DeclarationBuilder::addArgumentTypeHints(CallAst* node, DeclarationPointer function)
 {
-    DUChainReadLocker lock;
+    TimedDUChainReadLocker lock("DUChain read lock (DeclarationBuilder)");
     QPair<FunctionDeclaration::Ptr, bool> called = Helper::functionDeclarationForCalledDeclaration(function);
     FunctionDeclaration::Ptr lastFunctionDeclaration = called.first;
     bool isConstructor = called.second;
@@ -1085,7 +1172,7 @@ void DeclarationBuilder::addArgumentTypeHints(CallAst* node, DeclarationPointer
 
         // Update the parameter type: change both the type of the function argument,
         // and the type of the declaration which belongs to that argument
-        DUChainWriteLocker wlock;
+        TimedDUChainWriteLocker wlock("DUChain write lock (DeclarationBuilder)");
         if ( atVararg ) {
             indexInVararg++;
             Declaration* parameter = parameters.at(lastFunctionDeclaration->vararg()+hasSelfArgument);
@@ -1115,7 +1202,7 @@ void DeclarationBuilder::addArgumentTypeHints(CallAst* node, DeclarationPointer
     }
 
     lock.unlock();
-    DUChainWriteLocker wlock;
+    TimedDUChainWriteLocker wlock("DUChain write lock (DeclarationBuilder)");
     if ( lastFunctionDeclaration->kwarg() < 0 || parameters.isEmpty() ) {
         // no kwarg, stop here.
         return;
@@ -1228,14 +1315,14 @@ QVector<DeclarationBuilder::SourceType>
 void DeclarationBuilder::assignToName(NameAst* target, const DeclarationBuilder::SourceType& element)
 {
     if ( element.isAlias ) {
-        DUChainWriteLocker lock;
+        TimedDUChainWriteLocker lock("DUChain write lock (DeclarationBuilder)");
         Python::Identifier* identifier = target->identifier;
         AliasDeclaration* decl = eventuallyReopenDeclaration<AliasDeclaration>(identifier, target, AliasDeclarationType);
         decl->setAliasedDeclaration(element.declaration.data());
         closeDeclaration();
     }
     else {
-        DUChainWriteLocker lock;
+        TimedDUChainWriteLocker lock("DUChain write lock (DeclarationBuilder)");
         Declaration* dec = visitVariableDeclaration<Declaration>(target, 0, element.type);
         if ( dec && m_lastComment && ! m_lastComment->usedAsComment ) {
             dec->setComment(m_lastComment->value);
@@ -1274,7 +1361,7 @@ void DeclarationBuilder::assignToSubscript(SubscriptAst* subscript, const Declar
     }
     DeclarationPointer lastDecl = targetVisitor.lastDeclaration();
     if ( list && lastDecl ) {
-        DUChainWriteLocker lock;
+        TimedDUChainWriteLocker lock("DUChain write lock (DeclarationBuilder)");
         lastDecl->setAbstractType(list.cast<AbstractType>());
     }
 }
@@ -1298,7 +1385,7 @@ void DeclarationBuilder::assignToAttribute(AttributeAst* attrib, const Declarati
     }
     // while this is like A = foo(); A.bar = 3
     else {
-        DUChainReadLocker lock;
+        TimedDUChainReadLocker lock("DUChain read lock (DeclarationBuilder)");
         StructureType::Ptr structure(parentObjectDeclaration->abstractType().cast<StructureType>());
         if ( ! structure || ! structure->declaration(topContext()) ) {
             return;
@@ -1313,7 +1400,7 @@ void DeclarationBuilder::assignToAttribute(AttributeAst* attrib, const Declarati
 
     Declaration* attributeDeclaration = nullptr;
     {
-        DUChainReadLocker lock;
+        TimedDUChainReadLocker lock("DUChain read lock (DeclarationBuilder)");
         attributeDeclaration = Helper::accessAttribute(parentObjectDeclaration.data(),
                                                        attrib->attribute->value, currentContext());
     }
@@ -1338,7 +1425,7 @@ void DeclarationBuilder::assignToAttribute(AttributeAst* attrib, const Declarati
             if ( dec ) {
                 dec->setRange(RangeInRevision(internal->range().start, internal->range().start));
                 dec->setAutoDeclaration(true);
-                DUChainWriteLocker lock;
+                TimedDUChainWriteLocker lock("DUChain write lock (DeclarationBuilder)");
                 previousContext->createUse(dec->ownIndex(), editorFindRange(attrib, attrib));
             }
             else qCWarning(KDEV_PYTHON_DUCHAIN) << "No declaration created for " << attrib->attribute << "as parent is not a class";
@@ -1347,7 +1434,7 @@ void DeclarationBuilder::assignToAttribute(AttributeAst* attrib, const Declarati
         }
     }
     else {
-        DUChainWriteLocker lock;
+        TimedDUChainWriteLocker lock("DUChain write lock (DeclarationBuilder)");
         // the declaration is already there, just update the type
         if ( ! attributeDeclaration->type<FunctionType>() ) {
             auto newType = Helper::mergeTypes(attributeDeclaration->abstractType(), element.type);
@@ -1371,7 +1458,7 @@ void DeclarationBuilder::assignToTuple(TupleAst* tuple, const DeclarationBuilder
         if ( target->astType == Ast::StarredAstType ) {
             // PEP-3132. `a, *b, c = 1, 2, 3, 4 -> b = [2, 3]`
             // Starred expression is assigned a list of the values not used by unstarred ones.
-            DUChainReadLocker lock;
+            TimedDUChainReadLocker lock("DUChain read lock (DeclarationBuilder)");
             auto type = ExpressionVisitor::typeObjectForIntegralType<ListType>("list");
             lock.unlock();
             if ( !foundStarred ) { // Only allowed once, return unknown list.
@@ -1437,7 +1524,7 @@ void DeclarationBuilder::visitClassDefinition( ClassDefinitionAst* node )
 
     StructureType::Ptr type(new StructureType());
     
-    DUChainWriteLocker lock;
+    TimedDUChainWriteLocker lock("DUChain write lock (DeclarationBuilder)");
     ClassDeclaration* dec = eventuallyReopenDeclaration<ClassDeclaration>(node->name, node->name, NoTypeRequired);
     lock.unlock();
     visitDecorators<ClassDeclaration>(node->decorators, dec);
@@ -1485,7 +1572,7 @@ void DeclarationBuilder::visitClassDefinition( ClassDefinitionAst* node )
     // every python class inherits from "object".
     // We use this to add all the __str__, __get__, ... methods.
     if ( dec->baseClassesSize() == 0 && node->name->value != "object" ) {
-        DUChainWriteLocker wlock;
+        TimedDUChainWriteLocker wlock("DUChain write lock (DeclarationBuilder)");
         ReferencedTopDUContext docContext = Helper::getDocumentationFileContext();
         if ( docContext ) {
             QList<Declaration*> object = docContext->findDeclarations(
@@ -1563,7 +1650,7 @@ void DeclarationBuilder::visitFunctionDefinition( FunctionDefinitionAst* node )
     DeclarationPointer eventualParentDeclaration(currentDeclaration());
     FunctionType::Ptr type(new FunctionType());
 
-    DUChainWriteLocker lock;
+    TimedDUChainWriteLocker lock("DUChain write lock (DeclarationBuilder)");
     FunctionDeclaration* dec = eventuallyReopenDeclaration<FunctionDeclaration>(node->name, node->name,
                                                                                 FunctionDeclarationType);
 
@@ -1615,7 +1702,7 @@ void DeclarationBuilder::visitFunctionDefinition( FunctionDefinitionAst* node )
     
     {
         static IndexedString constructorName("__init__");
-        DUChainWriteLocker lock(DUChain::lock());
+        TimedDUChainWriteLocker lock("DUChain write lock (DeclarationBuilder)");
         if ( dec->identifier().identifier() == constructorName ) {
             // the constructor returns an instance of the object,
             // nice to display it in tooltips etc.
@@ -1647,26 +1734,22 @@ void DeclarationBuilder::visitFunctionDefinition( FunctionDefinitionAst* node )
                     description = i18n("First argument of class method is not called self, this is deprecated");
                 }
                 if ( ! description.isEmpty() ) {
-                    DUChainWriteLocker lock;
                     KDevelop::Problem *p = new KDevelop::Problem();
                     p->setDescription(description);
                     p->setFinalLocation(DocumentRange(currentlyParsedDocument(), parameters[0]->range().castToSimpleRange()));
                     p->setSource(KDevelop::IProblem::SemanticAnalysis);
                     p->setSeverity(KDevelop::IProblem::Warning);
-                    ProblemPointer ptr(p);
-                    topContext()->addProblem(ptr);
+                    reportProblem(ProblemPointer(p));
                 }
             }
             else if ( currentContext()->type() == DUContext::Class && parameters.isEmpty() ) {
-                DUChainWriteLocker lock;
                 KDevelop::Problem *p = new KDevelop::Problem();
                  // only mark first line
                 p->setFinalLocation(DocumentRange(currentlyParsedDocument(), KTextEditor::Range(node->startLine, node->startCol, node->startLine, 10000)));
                 p->setSource(KDevelop::IProblem::SemanticAnalysis);
                 p->setSeverity(KDevelop::IProblem::Warning);
                 p->setDescription(i18n("Non-static class method without arguments, must have at least one (self)"));
-                ProblemPointer ptr(p);
-                topContext()->addProblem(ptr);
+                reportProblem(ProblemPointer(p));
             }
         }
     }
@@ -1796,7 +1879,7 @@ void DeclarationBuilder::adjustExpressionsForTypecheck(Python::ExpressionAst* ad
         // do not motify types in the doc context
         return;
     }
-    DUChainWriteLocker lock;
+    TimedDUChainWriteLocker lock("DUChain write lock (DeclarationBuilder)");
     if ( useUnsure ) {
         adjust->setAbstractType(Helper::mergeTypes(adjust->abstractType(), hint));
     }
@@ -1813,18 +1896,16 @@ void DeclarationBuilder::visitReturn(ReturnAst* node)
     
     if ( node->value ) {
         if ( ! hasCurrentType() ) {
-            DUChainWriteLocker lock;
             KDevelop::Problem *p = new KDevelop::Problem();
             p->setFinalLocation(DocumentRange(currentlyParsedDocument(), node->range())); // only mark first line
             p->setSource(KDevelop::IProblem::SemanticAnalysis);
             p->setDescription(i18n("Return statement not within function declaration"));
-            ProblemPointer ptr(p);
-            topContext()->addProblem(ptr);
+            reportProblem(ProblemPointer(p));
         }
         else {
             TypePtr<FunctionType> t = currentType<FunctionType>();
             AbstractType::Ptr encountered = v.lastType();
-            DUChainWriteLocker lock;
+            TimedDUChainWriteLocker lock("DUChain write lock (DeclarationBuilder)");
             if ( t ) {
                 // Update the containing function's return type
                 t->setReturnType(Helper::mergeTypes(t->returnType(), encountered));
@@ -1866,7 +1947,7 @@ void DeclarationBuilder::visitArguments( ArgumentsAst* node )
         // Create a variable declaration for the parameter, to be used in the function body.
         Declaration* paramDeclaration = nullptr;
         if ( currentIndex == 1 && isClassMethod ) {
-            DUChainWriteLocker lock;
+            TimedDUChainWriteLocker lock("DUChain write lock (DeclarationBuilder)");
             AliasDeclaration* decl = eventuallyReopenDeclaration<AliasDeclaration>(arg->argumentName,
                                                                                    arg, AliasDeclarationType);
             if ( m_currentClassType ) {
@@ -1888,7 +1969,7 @@ void DeclarationBuilder::visitArguments( ArgumentsAst* node )
             ExpressionVisitor v(currentContext());
             v.visitNode(arg->annotation);
             if ( v.lastType() && v.isAlias() ) {
-                DUChainWriteLocker lock;
+                TimedDUChainWriteLocker lock("DUChain write lock (DeclarationBuilder)");
                 argumentType = Helper::mergeTypes(paramDeclaration->abstractType(), v.lastType());
             }
         }
@@ -1906,14 +1987,14 @@ void DeclarationBuilder::visitArguments( ArgumentsAst* node )
 
         qCDebug(KDEV_PYTHON_DUCHAIN) << "is first:" << isFirst << hasCurrentDeclaration() << currentDeclaration();
         if ( isFirst && hasCurrentDeclaration() && currentContext() && currentContext()->parentContext() ) {
-            DUChainReadLocker lock;
+            TimedDUChainReadLocker lock("DUChain read lock (DeclarationBuilder)");
             if ( currentContext()->parentContext()->type() == DUContext::Class ) {
                 argumentType = m_currentClassType.cast<AbstractType>();
                 isFirst = false;
             }
         }
 
-        DUChainWriteLocker lock;
+        TimedDUChainWriteLocker lock("DUChain write lock (DeclarationBuilder)");
         paramDeclaration->setAbstractType(Helper::mergeTypes(paramDeclaration->abstractType(), argumentType));
         type->addArgument(argumentType);
         if ( argumentType ) {
@@ -1936,7 +2017,7 @@ void DeclarationBuilder::visitArguments( ArgumentsAst* node )
             // this is new in python3, you can do like def fun(a, b, *c, z): pass
             useIndex = type->arguments().size();
         }
-        DUChainReadLocker lock;
+        TimedDUChainReadLocker lock("DUChain read lock (DeclarationBuilder)");
         IndexedContainer::Ptr tupleType = ExpressionVisitor::typeObjectForIntegralType<IndexedContainer>("tuple");
         lock.unlock();
         if ( tupleType ) {
@@ -1947,7 +2028,7 @@ void DeclarationBuilder::visitArguments( ArgumentsAst* node )
     }
 
     if ( node->kwarg ) {
-        DUChainReadLocker lock;
+        TimedDUChainReadLocker lock("DUChain read lock (DeclarationBuilder)");
         AbstractType::Ptr stringType = ExpressionVisitor::typeObjectForIntegralType<AbstractType>("str");
         auto dictType = ExpressionVisitor::typeObjectForIntegralType<MapType>("dict");
         lock.unlock();
@@ -1979,7 +2060,7 @@ void DeclarationBuilder::visitGlobal(GlobalAst* node)
     TopDUContext* top = topContext();
     foreach ( Identifier *id, node->names ) {
         QualifiedIdentifier qid = identifierForNode(id);
-        DUChainWriteLocker lock;
+        TimedDUChainWriteLocker lock("DUChain write lock (DeclarationBuilder)");
         QList< Declaration* > existing = top->findLocalDeclarations(qid.first());
         if ( ! existing.empty() ) {
             AliasDeclaration* ndec = openDeclaration<AliasDeclaration>(id, node);
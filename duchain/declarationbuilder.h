@@ -24,6 +24,7 @@
 #include <language/duchain/builders/abstractdeclarationbuilder.h>
 
 #include <QList>
+#include <QSet>
 
 #include "declarations/functiondeclaration.h"
 #include "typebuilder.h"
@@ -265,6 +266,15 @@ protected:
                                        const ReferencedTopDUContext& innerCtx, Declaration* aliasDeclaration = 0,
                                        const RangeInRevision& range = RangeInRevision::invalid());
 
+    /**
+     * @brief Declare the modules @p submodules of a package in its internal context, without resolving them.
+     * The declarations are of type "mixed", and the modules are neither looked up nor scheduled for parsing.
+     *
+     * @warning The DUChain must not be locked when this is called.
+     **/
+    void declareSubmodulePlaceholders(Declaration* package, const QStringList& submodules,
+                                      Identifier* declarationIdentifier);
+
     /**
      * @brief Find a declaration specified by "foo.bar.baz" in the given top context.
      *
@@ -301,6 +311,9 @@ private:
     StructureType::Ptr m_currentClassType;
     // missing modules, for not reporting them as unknown variables
     QVector<IndexedString> m_missingModules;
+    // dotted names like "os.path" which are accessed anywhere in the document; used to decide
+    // which submodules of an imported package need to be resolved
+    QSet<QString> m_accessedAttributeChains;
 
     StringAst* m_lastComment = nullptr;
 };
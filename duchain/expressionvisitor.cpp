@@ -24,6 +24,7 @@
 #include "pythonduchainexport.h"
 #include "pythoneditorintegrator.h"
 #include "helpers.h"
+#include "timedlocker.h"
 
 #include <language/duchain/types/containertypes.h>
 #include <language/duchain/types/unsuretype.h>
@@ -110,7 +111,7 @@ void ExpressionVisitor::visitAttribute(AttributeAst* node)
     // Like, for A.B.C where B is an instance of foo, when processing C, find all properties of foo which are called C.
     bool haveOneUsefulType = false;
     Declaration* foundDeclaration = nullptr;
-    DUChainReadLocker lock;
+    TimedDUChainReadLocker lock("DUChain read lock (ExpressionVisitor)");
     foreach ( StructureType::Ptr current, accessingAttributeOfType ) {
         if ( Helper::isUsefulType(current.cast<AbstractType>()) ) {
             haveOneUsefulType = true;
@@ -156,7 +157,7 @@ void ExpressionVisitor::visitCall(CallAst* node)
     }
     else if ( ! v.m_isAlias && v.lastType() && v.lastType()->whichType() == AbstractType::TypeStructure ) {
         // use __call__
-        DUChainReadLocker lock;
+        TimedDUChainReadLocker lock("DUChain read lock (ExpressionVisitor)");
         auto c = v.lastType().cast<StructureType>()->internalContext(topContext());
         if ( c ) {
             auto decls = c->findDeclarations(QualifiedIdentifier("__call__"));
@@ -181,7 +182,7 @@ void ExpressionVisitor::visitCall(CallAst* node)
         return encounterUnknown();
     }
 
-    DUChainReadLocker lock;
+    TimedDUChainReadLocker lock("DUChain read lock (ExpressionVisitor)");
     actualDeclaration = Helper::resolveAliasDeclaration(actualDeclaration);
     ClassDeclaration* classDecl = dynamic_cast<ClassDeclaration*>(actualDeclaration);
     QPair<FunctionDeclarationPointer, bool> d = Helper::functionDeclarationForCalledDeclaration(
@@ -262,7 +263,7 @@ void ExpressionVisitor::checkForDecorators(CallAst* node, FunctionDeclaration* f
         ExpressionVisitor baseTypeVisitor(this);
         // when calling foo.bar[3].baz.iteritems(), find the type of "foo.bar[3].baz"
         baseTypeVisitor.visitNode(static_cast<AttributeAst*>(node->function)->value);
-        DUChainWriteLocker lock;
+        TimedDUChainWriteLocker lock("DUChain write lock (ExpressionVisitor)");
         if ( auto t = baseTypeVisitor.lastType().cast<ListType>() ) {
             qCDebug(KDEV_PYTHON_DUCHAIN) << "Got container:" << t->toString();
             auto newType = typeObjectForIntegralType<ListType>("list");
@@ -292,7 +293,7 @@ void ExpressionVisitor::checkForDecorators(CallAst* node, FunctionDeclaration* f
         ExpressionVisitor enumeratedTypeVisitor(this);
         enumeratedTypeVisitor.visitNode(node->arguments.first());
 
-        DUChainWriteLocker lock;
+        TimedDUChainWriteLocker lock("DUChain write lock (ExpressionVisitor)");
         auto intType = typeObjectForIntegralType<AbstractType>("int");
         auto enumerated = enumeratedTypeVisitor.lastType();
         auto result = listOfTuples(intType, Helper::contentOfIterable(enumerated));
@@ -308,7 +309,7 @@ void ExpressionVisitor::checkForDecorators(CallAst* node, FunctionDeclaration* f
         ExpressionVisitor baseTypeVisitor(this);
         // when calling foo.bar[3].baz.iteritems(), find the type of "foo.bar[3].baz"
         baseTypeVisitor.visitNode(static_cast<AttributeAst*>(node->function)->value);
-        DUChainWriteLocker lock;
+        TimedDUChainWriteLocker lock("DUChain write lock (ExpressionVisitor)");
         if ( auto t = baseTypeVisitor.lastType().cast<MapType>() ) {
             qCDebug(KDEV_PYTHON_DUCHAIN) << "Got container:" << t->toString();
             auto resultingType = listOfTuples(t->keyType().abstractType(), t->contentType().abstractType());
@@ -368,7 +369,7 @@ void ExpressionVisitor::visitSubscript(SubscriptAst* node)
 {
     AstDefaultVisitor::visitNode(node->value);
     if ( node->slice && node->slice->astType == Ast::IndexAstType ) {
-        DUChainReadLocker lock;
+        TimedDUChainReadLocker lock("DUChain read lock (ExpressionVisitor)");
         auto indexedTypes = Helper::filterType<IndexedContainer>(lastType(), [](AbstractType::Ptr toFilter) {
             return toFilter.cast<IndexedContainer>();
         });
@@ -424,7 +425,7 @@ void ExpressionVisitor::visitSubscript(SubscriptAst* node)
     // Otherwise, try to use __getitem__.
     ExpressionVisitor v(context());
     v.visitNode(node->value);
-    DUChainReadLocker lock;
+    TimedDUChainReadLocker lock("DUChain read lock (ExpressionVisitor)");
     Declaration* function = Helper::accessAttribute(v.lastDeclaration().data(), "__getitem__", context());
     if ( function && function->isFunctionDeclaration() ) {
         if ( FunctionType::Ptr functionType = function->type<FunctionType>() ) {
@@ -438,7 +439,7 @@ void ExpressionVisitor::visitSubscript(SubscriptAst* node)
 
 void ExpressionVisitor::visitList(ListAst* node)
 {
-    DUChainReadLocker lock;
+    TimedDUChainReadLocker lock("DUChain read lock (ExpressionVisitor)");
     auto type = typeObjectForIntegralType<ListType>("list");
     lock.unlock();
     ExpressionVisitor contentVisitor(this);
@@ -457,7 +458,7 @@ void ExpressionVisitor::visitList(ListAst* node)
 
 void ExpressionVisitor::visitDictionaryComprehension(DictionaryComprehensionAst* node)
 {
-    DUChainReadLocker lock;
+    TimedDUChainReadLocker lock("DUChain read lock (ExpressionVisitor)");
     auto type = typeObjectForIntegralType<MapType>("dict");
     if ( type ) {
         DUContext* comprehensionContext = context()->findContextAt(CursorInRevision(node->startLine, node->startCol));
@@ -484,7 +485,7 @@ void ExpressionVisitor::visitDictionaryComprehension(DictionaryComprehensionAst*
 void ExpressionVisitor::visitSetComprehension(SetComprehensionAst* node)
 {
     Python::AstDefaultVisitor::visitSetComprehension(node);
-    DUChainReadLocker lock;
+    TimedDUChainReadLocker lock("DUChain read lock (ExpressionVisitor)");
     auto type = typeObjectForIntegralType<ListType>("set");
     if ( type ) {
         DUContext* comprehensionContext = context()->findContextAt(CursorInRevision(node->startLine, node->startCol), true);
@@ -502,7 +503,7 @@ void ExpressionVisitor::visitSetComprehension(SetComprehensionAst* node)
 void ExpressionVisitor::visitListComprehension(ListComprehensionAst* node)
 {
     AstDefaultVisitor::visitListComprehension(node);
-    DUChainReadLocker lock;
+    TimedDUChainReadLocker lock("DUChain read lock (ExpressionVisitor)");
     auto type = typeObjectForIntegralType<ListType>("list");
     if ( type && ! m_forceGlobalSearching ) { // TODO fixme
         DUContext* comprehensionContext = context()->findContextAt(CursorInRevision(node->startLine, node->startCol), true);
@@ -521,7 +522,7 @@ void ExpressionVisitor::visitListComprehension(ListComprehensionAst* node)
 }
 
 void ExpressionVisitor::visitTuple(TupleAst* node) {
-    DUChainReadLocker lock;
+    TimedDUChainReadLocker lock("DUChain read lock (ExpressionVisitor)");
     IndexedContainer::Ptr type = typeObjectForIntegralType<IndexedContainer>("tuple");
     if ( type ) {
         lock.unlock();
@@ -558,7 +559,7 @@ void ExpressionVisitor::visitIfExpression(IfExpressionAst* node)
 
 void ExpressionVisitor::visitSet(SetAst* node)
 {
-    DUChainReadLocker lock;
+    TimedDUChainReadLocker lock("DUChain read lock (ExpressionVisitor)");
     auto type = typeObjectForIntegralType<ListType>("set");
     lock.unlock();
     ExpressionVisitor contentVisitor(this);
@@ -573,7 +574,7 @@ void ExpressionVisitor::visitSet(SetAst* node)
 
 void ExpressionVisitor::visitDict(DictAst* node)
 {
-    DUChainReadLocker lock;
+    TimedDUChainReadLocker lock("DUChain read lock (ExpressionVisitor)");
     auto type = typeObjectForIntegralType<MapType>("dict");
     lock.unlock();
     ExpressionVisitor contentVisitor(this);
@@ -594,7 +595,7 @@ void ExpressionVisitor::visitDict(DictAst* node)
 void ExpressionVisitor::visitNumber(Python::NumberAst* number)
 {
     AbstractType::Ptr type;
-    DUChainReadLocker lock;
+    TimedDUChainReadLocker lock("DUChain read lock (ExpressionVisitor)");
     if ( number->isInt ) {
         type = typeObjectForIntegralType<AbstractType>("int");
     }
@@ -606,13 +607,13 @@ void ExpressionVisitor::visitNumber(Python::NumberAst* number)
 
 void ExpressionVisitor::visitString(Python::StringAst* )
 {
-    DUChainReadLocker lock;
+    TimedDUChainReadLocker lock("DUChain read lock (ExpressionVisitor)");
     StructureType::Ptr type = typeObjectForIntegralType<StructureType>("str");
     encounter(AbstractType::Ptr::staticCast(type));
 }
 
 void ExpressionVisitor::visitBytes(Python::BytesAst* ) {
-    DUChainReadLocker lock;
+    TimedDUChainReadLocker lock("DUChain read lock (ExpressionVisitor)");
     auto type = typeObjectForIntegralType<StructureType>("bytes");
     encounter(AbstractType::Ptr::staticCast(type));
 }
@@ -653,7 +654,7 @@ void ExpressionVisitor::visitName(Python::NameAst* node)
     else {
         range = RangeInRevision(0, 0, node->endLine, node->endCol);
     }
-    DUChainReadLocker lock;
+    TimedDUChainReadLocker lock("DUChain read lock (ExpressionVisitor)");
     Declaration* d = Helper::declarationForName(QualifiedIdentifier(node->identifier->value),
                                                 range, DUChainPointer<const DUContext>(context()));
 
@@ -676,7 +677,7 @@ void ExpressionVisitor::visitCompare(CompareAst* node)
 }
 
 AbstractType::Ptr ExpressionVisitor::fromBinaryOperator(AbstractType::Ptr lhs, AbstractType::Ptr rhs, const QString& op) {
-    DUChainReadLocker lock;
+    TimedDUChainReadLocker lock("DUChain read lock (ExpressionVisitor)");
     auto operatorReturnType = [&op, this](const AbstractType::Ptr& p) {
         StructureType::Ptr type = p.cast<StructureType>();
         if ( ! type ) {
@@ -687,7 +688,7 @@ AbstractType::Ptr ExpressionVisitor::fromBinaryOperator(AbstractType::Ptr lhs, A
             return AbstractType::Ptr();
         }
         auto operatorFunctionType = func->type<FunctionType>();
-        DUChainReadLocker lock;
+        TimedDUChainReadLocker lock("DUChain read lock (ExpressionVisitor)");
         auto context = Helper::getDocumentationFileContext();
         if ( context ) {
             auto object_decl = context->findDeclarations(QualifiedIdentifier("object"));
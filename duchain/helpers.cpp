@@ -55,21 +55,17 @@
 #include "types/indexedcontainer.h"
 #include "kdevpythonversion.h"
 #include "expressionvisitor.h"
+#include "correctionfileindex.h"
+#include "projectpaths.h"
 
 using namespace KDevelop;
 
 namespace Python {
 
-QMap<IProject*, QList<QUrl>> Helper::cachedCustomIncludes;
-QList<QUrl> Helper::cachedSearchPaths;
-QList<QUrl> Helper::projectSearchPaths;
 QStringList Helper::dataDirs;
 QString Helper::documentationFile;
 DUChainPointer<TopDUContext> Helper::documentationFileContext = DUChainPointer<TopDUContext>(0);
-QStringList Helper::correctionFileDirs;
 QString Helper::localCorrectionFileDir;
-QMutex Helper::cacheMutex;
-QMutex Helper::projectPathLock;
 
 void Helper::scheduleDependency(const IndexedString& dependency, int betterThanPriority)
 {
@@ -283,6 +279,17 @@ QString Helper::getDocumentationFile() {
     return Helper::documentationFile;
 }
 
+bool Helper::isDocumentationFile(const IndexedString& document)
+{
+    const QString path = document.toUrl().toLocalFile();
+    foreach ( const QString& dir, getDataDirs() ) {
+        if ( path.startsWith(dir + '/') ) {
+            return true;
+        }
+    }
+    return false;
+}
+
 ReferencedTopDUContext Helper::getDocumentationFileContext()
 {
     if ( Helper::documentationFileContext ) {
@@ -298,64 +305,14 @@ ReferencedTopDUContext Helper::getDocumentationFileContext()
     return ReferencedTopDUContext(0); // c++...
 }
 
-// stolen from KUrl. duh.
-static QString _relativePath(const QString &base_dir, const QString &path)
-{
-   QString _base_dir(QDir::cleanPath(base_dir));
-   QString _path(QDir::cleanPath(path.isEmpty() || QDir::isRelativePath(path) ? _base_dir+QLatin1Char('/')+path : path));
-
-   if (_base_dir.isEmpty())
-      return _path;
-
-   if (_base_dir[_base_dir.length()-1] != QLatin1Char('/'))
-      _base_dir.append(QLatin1Char('/') );
-
-   const QStringList list1 = _base_dir.split(QLatin1Char('/'), QString::SkipEmptyParts);
-   const QStringList list2 = _path.split(QLatin1Char('/'), QString::SkipEmptyParts);
-
-   // Find where they meet
-   int level = 0;
-   int maxLevel = qMin(list1.count(), list2.count());
-   while((level < maxLevel) && (list1[level] == list2[level])) level++;
-
-   QString result;
-   // Need to go down out of the first path to the common branch.
-   for(int i = level; i < list1.count(); i++)
-      result.append(QLatin1String("../"));
-
-   // Now up up from the common branch to the second path.
-   for(int i = level; i < list2.count(); i++)
-      result.append(list2[i]).append(QLatin1Char('/'));
-
-   if ((level < list2.count()) && (path[path.length()-1] != QLatin1Char('/')))
-      result.truncate(result.length()-1);
-
-   return result;
-}
-
 QUrl Helper::getCorrectionFile(const QUrl& document)
 {
-    if ( Helper::correctionFileDirs.isEmpty() ) {
-        Helper::correctionFileDirs = QStandardPaths::locateAll(QStandardPaths::GenericDataLocation,
-                                                               "kdevpythonsupport/correction_files/",
-                                                               QStandardPaths::LocateDirectory);
+    auto index = CorrectionFileIndex::self();
+    if ( ! index->mightHaveCorrectionFile(document) ) {
+        // the common case, no need to compute the search paths
+        return {};
     }
-
-    foreach (QString correctionFileDir, correctionFileDirs) {
-        foreach ( const QUrl& basePath, Helper::getSearchPaths(QUrl()) ) {
-            if ( ! basePath.isParentOf(document) ) {
-                continue;
-            }
-            auto base = basePath.path();
-            auto doc = document.path();
-            auto relative = _relativePath(base, doc);
-            auto fullPath = correctionFileDir + "/" + relative;
-            if ( QFile::exists(fullPath) ) {
-                return QUrl::fromLocalFile(fullPath).adjusted(QUrl::NormalizePathSegments);
-            }
-        }
-    }
-    return {};
+    return index->correctionFile(document, Helper::getSearchPaths(QUrl()));
 }
 
 QUrl Helper::getLocalCorrectionFile(const QUrl& document)
@@ -424,59 +381,55 @@ QString getPythonExecutablePath() {
     return PYTHON_EXECUTABLE;
 }
 
+namespace {
+QList<QUrl> interpreterSearchPaths()
+{
+    qCDebug(KDEV_PYTHON_DUCHAIN) << "*** Gathering search paths...";
+    QList<QUrl> result;
+    QStringList getpath;
+    getpath << "-c" << "import sys; sys.stdout.write('$|$'.join(sys.path))";
+
+    QProcess python;
+    python.start(getPythonExecutablePath(), getpath);
+    python.waitForFinished(1000);
+    QString pythonpath = QString::fromUtf8(python.readAllStandardOutput());
+    auto paths = pythonpath.split("$|$");
+    paths.removeAll("");
+
+    if ( ! pythonpath.isEmpty() ) {
+        foreach ( const QString& path, paths ) {
+            result.append(QUrl::fromLocalFile(path));
+        }
+    }
+    else {
+        qCWarning(KDEV_PYTHON_DUCHAIN) << "Could not get search paths! Defaulting to stupid stuff.";
+        result.append(QUrl::fromLocalFile("/usr/lib/python3.5"));
+        result.append(QUrl::fromLocalFile("/usr/lib/python3.5/site-packages"));
+        QString path = qgetenv("PYTHONPATH");
+        QStringList paths = path.split(':');
+        foreach ( const QString& path, paths ) {
+            result.append(QUrl::fromLocalFile(path));
+        }
+    }
+    qCDebug(KDEV_PYTHON_DUCHAIN) << " *** Done. Got search paths: " << result;
+    return result;
+}
+}
+
 QList<QUrl> Helper::getSearchPaths(const QUrl& workingOnDocument)
 {
-    QMutexLocker lock(&Helper::cacheMutex);
-    QList<QUrl> searchPaths;
     // search in the projects, as they're packages and likely to be installed or added to PYTHONPATH later
     // and also add custom include paths that are defined in the projects
+    QList<QUrl> searchPaths = ProjectPaths::searchPaths(workingOnDocument);
 
-    {
-        auto project = ICore::self()->projectController()->findProjectForUrl(workingOnDocument);
-        QMutexLocker lock(&Helper::projectPathLock);
-        searchPaths << Helper::projectSearchPaths;
-        searchPaths << Helper::cachedCustomIncludes.value(project);
-    }
-    
     foreach ( const QString& path, getDataDirs() ) {
         searchPaths.append(QUrl::fromLocalFile(path));
     }
 
-    if ( cachedSearchPaths.isEmpty() ) {
-        qCDebug(KDEV_PYTHON_DUCHAIN) << "*** Gathering search paths...";
-        QStringList getpath;
-        getpath << "-c" << "import sys; sys.stdout.write('$|$'.join(sys.path))";
-        
-        QProcess python;
-        python.start(getPythonExecutablePath(), getpath);
-        python.waitForFinished(1000);
-        QString pythonpath = QString::fromUtf8(python.readAllStandardOutput());
-        auto paths = pythonpath.split("$|$");
-        paths.removeAll("");
-        
-        if ( ! pythonpath.isEmpty() ) {
-            foreach ( const QString& path, paths ) {
-                cachedSearchPaths.append(QUrl::fromLocalFile(path));
-            }
-        }
-        else {
-            qCWarning(KDEV_PYTHON_DUCHAIN) << "Could not get search paths! Defaulting to stupid stuff.";
-            searchPaths.append(QUrl::fromLocalFile("/usr/lib/python3.5"));
-            searchPaths.append(QUrl::fromLocalFile("/usr/lib/python3.5/site-packages"));
-            QString path = qgetenv("PYTHONPATH");
-            QStringList paths = path.split(':');
-            foreach ( const QString& path, paths ) {
-                cachedSearchPaths.append(QUrl::fromLocalFile(path));
-            }
-        }
-        qCDebug(KDEV_PYTHON_DUCHAIN) << " *** Done. Got search paths: " << cachedSearchPaths;
-    }
-    else {
-        qCDebug(KDEV_PYTHON_DUCHAIN) << " --- Search paths from cache: " << cachedSearchPaths;
-    }
-    
+    // the interpreter is only asked once; initialization of the static is thread-safe
+    static const QList<QUrl> cachedSearchPaths = interpreterSearchPaths();
     searchPaths.append(cachedSearchPaths);
-    
+
     auto dir = workingOnDocument.adjusted(QUrl::RemoveFilename);
     if ( ! dir.isEmpty() ) {
         // search in the current packages
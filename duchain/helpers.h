@@ -53,24 +53,18 @@ public:
     static QList<QUrl> getSearchPaths(const QUrl& workingOnDocument);
     static QStringList dataDirs;
     static QString documentationFile;
-    static QStringList correctionFileDirs;
     static QString localCorrectionFileDir;
     static DUChainPointer<TopDUContext> documentationFileContext;
 
     static QStringList getDataDirs();
     static QString getDocumentationFile();
     static ReferencedTopDUContext getDocumentationFileContext();
+    /// Whether @p document is one of the documentation files shipped with (or generated for) the plugin
+    static bool isDocumentationFile(const IndexedString& document);
 
     static QUrl getCorrectionFile(const QUrl& document);
     static QUrl getLocalCorrectionFile(const QUrl& document);
 
-    static QMutex cacheMutex;
-    static QMap<IProject*, QList<QUrl>> cachedCustomIncludes;
-    static QList<QUrl> cachedSearchPaths;
-
-    static QMutex projectPathLock;
-    static QList<QUrl> projectSearchPaths;
-
     static AbstractType::Ptr extractTypeHints(AbstractType::Ptr type);
 
     static Declaration* accessAttribute(Declaration* accessed, const QString& attribute, const DUContext* current);
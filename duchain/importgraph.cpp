@@ -0,0 +1,215 @@
+/*****************************************************************************
+ * This file is part of KDevelop                                             *
+ * Copyright 2026 agent <agent@local>                                        *
+ *                                                                           *
+ * This program is free software; you can redistribute it and/or             *
+ * modify it under the terms of the GNU General Public License as            *
+ * published by the Free Software Foundation; either version 2 of            *
+ * the License, or (at your option) any later version.                       *
+ *                                                                           *
+ * This program is distributed in the hope that it will be useful,           *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the             *
+ * GNU General Public License for more details.                              *
+ *                                                                           *
+ * You should have received a copy of the GNU General Public License         *
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.     *
+ *****************************************************************************
+ */
+
+#include "importgraph.h"
+
+#include "contextbuilder.h"
+
+#include <QDir>
+#include <QFile>
+#include <QRegularExpression>
+#include <QSet>
+
+#include <QDebug>
+#include "duchaindebug.h"
+
+namespace Python
+{
+
+namespace {
+QUrl normalized(const QUrl& url)
+{
+    return QUrl::fromLocalFile(QDir::cleanPath(url.toLocalFile()));
+}
+
+// "a.b as c" -> "a.b", "(x, " -> "x"
+QString firstName(QString item)
+{
+    item.remove('(').remove(')').remove('\\');
+    return item.trimmed().section(' ', 0, 0, QString::SectionSkipEmpty);
+}
+}
+
+QStringList ImportGraph::scanImports(const QString& contents)
+{
+    static const QRegularExpression importLine(QStringLiteral("^\\s*import\\s+([^#;]+)"));
+    static const QRegularExpression fromLine(QStringLiteral("^\\s*from\\s+(\\.*[\\w.]*)\\s+import\\s+([^#;]+)"));
+
+    QStringList modules;
+    foreach ( const QString& line, contents.split('\n') ) {
+        if ( ! line.contains(QLatin1String("import")) ) {
+            continue;
+        }
+        auto match = fromLine.match(line);
+        if ( match.hasMatch() ) {
+            const QString module = match.captured(1);
+            const bool onlyDots = module.count('.') == module.size();
+            if ( ! onlyDots ) {
+                modules.append(module);
+            }
+            foreach ( const QString& item, match.captured(2).split(',') ) {
+                const QString name = firstName(item);
+                if ( name.isEmpty() || name == QLatin1String("*") ) {
+                    continue;
+                }
+                modules.append(onlyDots ? module + name : module + '.' + name);
+            }
+            continue;
+        }
+        match = importLine.match(line);
+        if ( match.hasMatch() ) {
+            foreach ( const QString& item, match.captured(1).split(',') ) {
+                const QString name = firstName(item);
+                if ( ! name.isEmpty() ) {
+                    modules.append(name);
+                }
+            }
+        }
+    }
+    modules.removeDuplicates();
+    return modules;
+}
+
+ImportGraph ImportGraph::fromFiles(const QList<QUrl>& files)
+{
+    ImportGraph graph;
+    foreach ( const QUrl& file, files ) {
+        graph.addFile(normalized(file));
+    }
+    foreach ( const QUrl& file, graph.m_files ) {
+        QFile f(file.toLocalFile());
+        if ( ! f.open(QIODevice::ReadOnly) ) {
+            continue;
+        }
+        const QString contents = QString::fromUtf8(f.readAll());
+        foreach ( const QString& module, scanImports(contents) ) {
+            const QUrl dependency = normalized(ContextBuilder::findModulePath(module, file).first);
+            if ( dependency != file && graph.m_index.contains(dependency) ) {
+                graph.addDependency(file, dependency);
+            }
+        }
+    }
+    qCDebug(KDEV_PYTHON_DUCHAIN) << "import graph built for" << graph.size() << "files";
+    return graph;
+}
+
+void ImportGraph::addFile(const QUrl& file)
+{
+    if ( m_index.contains(file) ) {
+        return;
+    }
+    m_index.insert(file, m_files.size());
+    m_files.append(file);
+    m_dependencies.append(QVector<int>());
+}
+
+void ImportGraph::addDependency(const QUrl& file, const QUrl& dependency)
+{
+    Q_ASSERT(m_index.contains(file) && m_index.contains(dependency));
+    auto& dependencies = m_dependencies[m_index.value(file)];
+    const int target = m_index.value(dependency);
+    if ( ! dependencies.contains(target) ) {
+        dependencies.append(target);
+    }
+}
+
+int ImportGraph::size() const
+{
+    return m_files.size();
+}
+
+QHash<QUrl, int> ImportGraph::levels() const
+{
+    // Tarjan's algorithm for strongly connected components (i.e. import cycles).
+    // It finishes a component only after all components reachable from it are finished,
+    // so the level of each component can be computed right when it is found.
+    // An explicit stack is used instead of recursion, since import chains can be very long.
+    const int count = m_files.size();
+    QVector<int> index(count, -1);
+    QVector<int> lowlink(count, 0);
+    QVector<int> component(count, -1);
+    QVector<bool> onStack(count, false);
+    QVector<int> componentLevels;
+    QVector<int> stack;
+    // (node, index of the next dependency to look at)
+    QVector<QPair<int, int>> callStack;
+    int nextIndex = 0;
+
+    for ( int root = 0; root < count; root++ ) {
+        if ( index[root] != -1 ) {
+            continue;
+        }
+        callStack.append(qMakePair(root, 0));
+        while ( ! callStack.isEmpty() ) {
+            const int node = callStack.last().first;
+            const int edge = callStack.last().second;
+            if ( index[node] == -1 ) {
+                index[node] = lowlink[node] = nextIndex++;
+                stack.append(node);
+                onStack[node] = true;
+            }
+            const auto& dependencies = m_dependencies.at(node);
+            if ( edge < dependencies.size() ) {
+                callStack.last().second++;
+                const int next = dependencies.at(edge);
+                if ( index[next] == -1 ) {
+                    callStack.append(qMakePair(next, 0));
+                }
+                else if ( onStack[next] ) {
+                    lowlink[node] = qMin(lowlink[node], index[next]);
+                }
+                continue;
+            }
+            if ( lowlink[node] == index[node] ) {
+                const int current = componentLevels.size();
+                QVector<int> members;
+                int member = -1;
+                do {
+                    member = stack.takeLast();
+                    onStack[member] = false;
+                    component[member] = current;
+                    members.append(member);
+                } while ( member != node );
+                int level = 0;
+                foreach ( int m, members ) {
+                    foreach ( int dependency, m_dependencies.at(m) ) {
+                        if ( component[dependency] != current ) {
+                            level = qMax(level, componentLevels.at(component[dependency]) + 1);
+                        }
+                    }
+                }
+                componentLevels.append(level);
+            }
+            callStack.removeLast();
+            if ( ! callStack.isEmpty() ) {
+                const int parent = callStack.last().first;
+                lowlink[parent] = qMin(lowlink[parent], lowlink[node]);
+            }
+        }
+    }
+
+    QHash<QUrl, int> result;
+    result.reserve(count);
+    for ( int i = 0; i < count; i++ ) {
+        result.insert(m_files.at(i), componentLevels.at(component.at(i)));
+    }
+    return result;
+}
+
+}
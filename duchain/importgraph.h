@@ -0,0 +1,86 @@
+/*****************************************************************************
+ * This file is part of KDevelop                                             *
+ * Copyright 2026 agent <agent@local>                                        *
+ *                                                                           *
+ * This program is free software; you can redistribute it and/or             *
+ * modify it under the terms of the GNU General Public License as            *
+ * published by the Free Software Foundation; either version 2 of            *
+ * the License, or (at your option) any later version.                       *
+ *                                                                           *
+ * This program is distributed in the hope that it will be useful,           *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the             *
+ * GNU General Public License for more details.                              *
+ *                                                                           *
+ * You should have received a copy of the GNU General Public License         *
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.     *
+ *****************************************************************************
+ */
+
+#ifndef PYTHON_IMPORTGRAPH_H
+#define PYTHON_IMPORTGRAPH_H
+
+#include <QHash>
+#include <QList>
+#include <QStringList>
+#include <QUrl>
+#include <QVector>
+
+#include "pythonduchainexport.h"
+
+namespace Python
+{
+
+/**
+ * @brief Which file imports which other file, for a fixed set of files.
+ *
+ * Used to parse a project bottom-up: if every file is parsed after the files it imports,
+ * no file has to be parsed a second time because of imports which were not available yet.
+ */
+class KDEVPYTHONDUCHAIN_EXPORT ImportGraph
+{
+public:
+    /**
+     * @brief Find the modules imported in @p contents, without running the python parser.
+     *
+     * This is a cheap, line-based scan; for "from foo import bar" both "foo" and "foo.bar" are returned,
+     * since "bar" might be a module as well. Relative imports keep their leading dots.
+     */
+    static QStringList scanImports(const QString& contents);
+
+    /**
+     * @brief Build the graph for @p files by reading them from disk and resolving their imports.
+     * Imports which resolve to files not in @p files are ignored.
+     */
+    static ImportGraph fromFiles(const QList<QUrl>& files);
+
+    /**
+     * @brief Add @p file as a node; does nothing if it is already in the graph.
+     */
+    void addFile(const QUrl& file);
+
+    /**
+     * @brief Record that @p file imports @p dependency. Both must have been added before.
+     */
+    void addDependency(const QUrl& file, const QUrl& dependency);
+
+    /**
+     * @brief Assign a level to each file, such that each file only imports files with a lower level.
+     *
+     * Files which import each other (directly or through other files) can't be ordered,
+     * and get the same level. Files which don't import anything in the graph have level 0.
+     * Files with the same level are independent and can be parsed in parallel.
+     */
+    QHash<QUrl, int> levels() const;
+
+    int size() const;
+
+private:
+    QVector<QUrl> m_files;
+    QHash<QUrl, int> m_index;
+    QVector<QVector<int>> m_dependencies;
+};
+
+}
+
+#endif // PYTHON_IMPORTGRAPH_H
@@ -0,0 +1,314 @@
+/*****************************************************************************
+ * This file is part of KDevelop                                             *
+ * Copyright 2026 agent <agent@local>                                        *
+ *                                                                           *
+ * This program is free software; you can redistribute it and/or             *
+ * modify it under the terms of the GNU General Public License as            *
+ * published by the Free Software Foundation; either version 2 of            *
+ * the License, or (at your option) any later version.                       *
+ *                                                                           *
+ * This program is distributed in the hope that it will be useful,           *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the             *
+ * GNU General Public License for more details.                              *
+ *                                                                           *
+ * You should have received a copy of the GNU General Public License         *
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.     *
+ *****************************************************************************
+ */
+
+#include "moduleindex.h"
+
+#include <QDir>
+#include <QFileInfo>
+#include <QFileSystemWatcher>
+#include <QQueue>
+#include <QRunnable>
+
+#include <QDebug>
+#include "duchaindebug.h"
+
+namespace Python
+{
+
+namespace {
+// Limits the memory and the number of watched directories for search paths with huge trees below them
+// (e.g. a project containing a data directory). Directories not indexed are looked up on the disk.
+const int maxIndexedDirectories = 20000;
+}
+
+class ModuleIndex::IndexJob : public QRunnable
+{
+public:
+    enum Depth {
+        WholeTree,
+        // only the directory itself, which is already indexed
+        SingleDirectory
+    };
+
+    IndexJob(ModuleIndex* index, const QString& root, Depth depth = WholeTree)
+        : m_index(index)
+        , m_root(root)
+        , m_depth(depth)
+    {
+    }
+
+    void run() override
+    {
+        if ( m_depth == SingleDirectory ) {
+            Directory directory;
+            const bool exists = QFileInfo(m_root).isDir();
+            if ( exists ) {
+                read(m_root, &directory, nullptr);
+            }
+            m_index->update(m_root, exists, directory);
+            return;
+        }
+        QHash<QString, Directory> directories;
+        QSet<QString> visited;
+        QQueue<QString> pending;
+        pending.enqueue(m_root);
+        while ( ! pending.isEmpty() && directories.size() < maxIndexedDirectories ) {
+            if ( m_index->isShuttingDown() ) {
+                return;
+            }
+            const QString path = pending.dequeue();
+            const QFileInfo info(path);
+            // symlinks might form a loop
+            if ( ! info.isDir() || visited.contains(info.canonicalFilePath()) ) {
+                continue;
+            }
+            visited.insert(info.canonicalFilePath());
+            read(path, &directories[path], &pending);
+        }
+        qCDebug(KDEV_PYTHON_DUCHAIN) << "indexed" << directories.size() << "directories below" << m_root;
+        m_index->insert(m_root, directories);
+    }
+
+    // whether the tree below the sub-directory @p name needs to be indexed
+    static bool isIndexed(const QString& name)
+    {
+        return ! name.contains('.') && name != QLatin1String("__pycache__");
+    }
+
+private:
+    static void read(const QString& path, Directory* directory, QQueue<QString>* pending)
+    {
+        foreach ( const QFileInfo& entry, QDir(path).entryInfoList(QDir::Files | QDir::Dirs | QDir::NoDotAndDotDot) ) {
+            const QString name = entry.fileName();
+            if ( entry.isFile() ) {
+                directory->files.insert(name);
+            }
+            else if ( ! name.contains('-') ) {
+                // Names containing "-" are not valid modules but often e.g. .egg directories,
+                // and names containing "." can't be imported, so there's no need to look inside those.
+                directory->directories.insert(name);
+                if ( pending && isIndexed(name) ) {
+                    pending->enqueue(path + '/' + name);
+                }
+            }
+        }
+    }
+
+    ModuleIndex* m_index;
+    QString m_root;
+    Depth m_depth;
+};
+
+ModuleIndex* ModuleIndex::self()
+{
+    static ModuleIndex* index = new ModuleIndex();
+    return index;
+}
+
+ModuleIndex::ModuleIndex()
+    : m_watcher(new QFileSystemWatcher(this))
+{
+    // one thread is enough, and keeps the jobs for a changed directory in order
+    m_pool.setMaxThreadCount(1);
+    connect(m_watcher, &QFileSystemWatcher::directoryChanged, this, &ModuleIndex::directoryChanged);
+    // the watcher lives in the thread the index was created in, while indexing happens in the pool
+    connect(this, &ModuleIndex::directoriesIndexed, this, [this](const QStringList& directories) {
+        if ( ! directories.isEmpty() ) {
+            m_watcher->addPaths(directories);
+        }
+    }, Qt::QueuedConnection);
+    connect(this, &ModuleIndex::directoriesRemoved, this, [this](const QStringList& directories) {
+        if ( ! directories.isEmpty() ) {
+            m_watcher->removePaths(directories);
+        }
+    }, Qt::QueuedConnection);
+}
+
+void ModuleIndex::index(const QList<QUrl>& searchPaths)
+{
+    if ( isShuttingDown() ) {
+        return;
+    }
+    QStringList newRoots;
+    {
+        QReadLocker lock(&m_lock);
+        foreach ( const QUrl& path, searchPaths ) {
+            const QString root = QDir::cleanPath(path.toLocalFile());
+            if ( ! root.isEmpty() && ! m_roots.contains(root) && ! newRoots.contains(root) ) {
+                newRoots.append(root);
+            }
+        }
+    }
+    if ( newRoots.isEmpty() ) {
+        return;
+    }
+    QWriteLocker lock(&m_lock);
+    foreach ( const QString& root, newRoots ) {
+        // another thread might have queued it in the meantime
+        if ( m_roots.contains(root) ) {
+            continue;
+        }
+        m_roots.insert(root);
+        if ( ! m_directories.contains(root) ) {
+            m_pool.start(new IndexJob(this, root));
+        }
+    }
+}
+
+void ModuleIndex::insert(const QString& root, const QHash<QString, Directory>& directories)
+{
+    QWriteLocker lock(&m_lock);
+    if ( ! m_roots.contains(root) ) {
+        return;
+    }
+    for ( auto it = directories.constBegin(); it != directories.constEnd(); it++ ) {
+        m_directories.insert(it.key(), it.value());
+    }
+    emit directoriesIndexed(directories.keys());
+}
+
+void ModuleIndex::directoryChanged(const QString& directory)
+{
+    // Saving a file renames a temporary file in its directory; reading that directory alone is enough
+    // to notice new or removed sub-directories, and lookups keep using its old contents in the meantime.
+    if ( ! isShuttingDown() ) {
+        m_pool.start(new IndexJob(this, QDir::cleanPath(directory), IndexJob::SingleDirectory));
+    }
+}
+
+void ModuleIndex::update(const QString& path, bool exists, const Directory& contents)
+{
+    QStringList removed;
+    QWriteLocker lock(&m_lock);
+    const auto it = m_directories.find(path);
+    if ( it == m_directories.end() ) {
+        // removed together with its parent in the meantime
+        return;
+    }
+    if ( ! exists ) {
+        removeTree(path, &removed);
+        emit directoriesRemoved(removed);
+        return;
+    }
+    const QSet<QString> previous = it->directories;
+    it.value() = contents;
+    foreach ( const QString& name, previous ) {
+        if ( ! contents.directories.contains(name) ) {
+            removeTree(path + '/' + name, &removed);
+        }
+    }
+    foreach ( const QString& name, contents.directories ) {
+        const QString added = path + '/' + name;
+        if ( ! previous.contains(name) && IndexJob::isIndexed(name) && ! m_roots.contains(added) ) {
+            // look at the disk until the new tree is indexed
+            m_roots.insert(added);
+            m_pool.start(new IndexJob(this, added));
+        }
+    }
+    emit directoriesRemoved(removed);
+    qCDebug(KDEV_PYTHON_DUCHAIN) << "updated" << path << "removed" << removed.size() << "directories";
+}
+
+void ModuleIndex::removeTree(const QString& root, QStringList* removed)
+{
+    const QString below = root + '/';
+    for ( auto it = m_directories.begin(); it != m_directories.end(); ) {
+        if ( it.key() == root || it.key().startsWith(below) ) {
+            removed->append(it.key());
+            it = m_directories.erase(it);
+        }
+        else {
+            it++;
+        }
+    }
+    for ( auto it = m_roots.begin(); it != m_roots.end(); ) {
+        if ( *it == root || it->startsWith(below) ) {
+            it = m_roots.erase(it);
+        }
+        else {
+            it++;
+        }
+    }
+}
+
+bool ModuleIndex::contents(const QString& directory, Directory* result)
+{
+    QReadLocker lock(&m_lock);
+    const auto it = m_directories.constFind(QDir::cleanPath(directory));
+    if ( it == m_directories.constEnd() ) {
+        return false;
+    }
+    *result = it.value();
+    return true;
+}
+
+bool ModuleIndex::findModulePath(const QString& name, const QList<QUrl>& searchPaths, QPair<QUrl, QStringList>* result)
+{
+    if ( name.startsWith('.') || name.contains('*') ) {
+        return false;
+    }
+    const QStringList nameComponents = name.split('.');
+    QReadLocker lock(&m_lock);
+    // same order of checks as in ContextBuilder::findModulePath()
+    foreach ( const QUrl& currentPath, searchPaths ) {
+        QString path = QDir::cleanPath(currentPath.toLocalFile());
+        QStringList leftNameComponents = nameComponents;
+        foreach ( const QString& component, nameComponents ) {
+            const auto directory = m_directories.constFind(path);
+            if ( directory == m_directories.constEnd() ) {
+                return false;
+            }
+            leftNameComponents.removeFirst();
+            const QString testFilename = path + '/' + component;
+            const bool dirExists = directory->directories.contains(component);
+            if ( ! dirExists || leftNameComponents.isEmpty() ) {
+                for ( const char* extension : {".py", ".pyx"} ) {
+                    if ( directory->files.contains(component + extension) ) {
+                        *result = qMakePair(QUrl::fromLocalFile(testFilename + extension), leftNameComponents);
+                        return true;
+                    }
+                    else if ( dirExists ) {
+                        *result = qMakePair(QUrl::fromLocalFile(testFilename + "/__init__.py"), leftNameComponents);
+                        return true;
+                    }
+                }
+            }
+            if ( ! dirExists ) {
+                break;
+            }
+            path = testFilename;
+        }
+    }
+    *result = {};
+    return true;
+}
+
+void ModuleIndex::shutdown()
+{
+    m_shuttingDown.store(1);
+    m_pool.clear();
+    m_pool.waitForDone();
+}
+
+bool ModuleIndex::isShuttingDown() const
+{
+    return m_shuttingDown.load() != 0;
+}
+
+}
@@ -0,0 +1,115 @@
+/*****************************************************************************
+ * This file is part of KDevelop                                             *
+ * Copyright 2026 agent <agent@local>                                        *
+ *                                                                           *
+ * This program is free software; you can redistribute it and/or             *
+ * modify it under the terms of the GNU General Public License as            *
+ * published by the Free Software Foundation; either version 2 of            *
+ * the License, or (at your option) any later version.                       *
+ *                                                                           *
+ * This program is distributed in the hope that it will be useful,           *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the             *
+ * GNU General Public License for more details.                              *
+ *                                                                           *
+ * You should have received a copy of the GNU General Public License         *
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.     *
+ *****************************************************************************
+ */
+
+#ifndef PYTHON_MODULEINDEX_H
+#define PYTHON_MODULEINDEX_H
+
+#include <QAtomicInt>
+#include <QHash>
+#include <QObject>
+#include <QPair>
+#include <QReadWriteLock>
+#include <QSet>
+#include <QStringList>
+#include <QThreadPool>
+#include <QUrl>
+
+#include "pythonduchainexport.h"
+
+class QFileSystemWatcher;
+
+namespace Python
+{
+
+/**
+ * @brief In-memory tree of the modules and packages below the search paths, for import completion.
+ *
+ * Search paths are indexed in a background thread the first time they are passed to index(); until then,
+ * lookups return false and callers have to look at the disk themselves. Indexed directories are watched for
+ * changes: a changed directory is read again on its own, and only sub-directories which were added to it are
+ * indexed like new search paths. The index should be created on the main thread (by calling self() there once),
+ * so the file system watcher can deliver its notifications.
+ */
+class KDEVPYTHONDUCHAIN_EXPORT ModuleIndex : public QObject
+{
+    Q_OBJECT
+public:
+    struct Directory {
+        /// names of the files in the directory, with extension
+        QSet<QString> files;
+        /// names of the sub-directories which could be packages
+        QSet<QString> directories;
+    };
+
+    static ModuleIndex* self();
+
+    /**
+     * @brief Queue indexing of those of the @p searchPaths which are not indexed yet. Does not block.
+     */
+    void index(const QList<QUrl>& searchPaths);
+
+    /**
+     * @brief Get the indexed contents of @p directory.
+     * @return false if the directory is not (yet) indexed
+     */
+    bool contents(const QString& directory, Directory* result);
+
+    /**
+     * @brief Like ContextBuilder::findModulePath() for non-relative imports, but without touching the disk.
+     * @param result set to the file and the names left to resolve inside it; to an invalid URL if there is no such module
+     * @return false if one of the @p searchPaths is not (yet) indexed, then @p result is not set
+     */
+    bool findModulePath(const QString& name, const QList<QUrl>& searchPaths, QPair<QUrl, QStringList>* result);
+
+    /**
+     * @brief Stop indexing and wait for the background thread; call this before unloading the plugin.
+     */
+    void shutdown();
+
+signals:
+    void directoriesIndexed(const QStringList& directories);
+    void directoriesRemoved(const QStringList& directories);
+
+private:
+    class IndexJob;
+    friend class IndexJob;
+
+    ModuleIndex();
+    void directoryChanged(const QString& directory);
+    // called from the background thread with the contents of a newly indexed tree
+    void insert(const QString& root, const QHash<QString, Directory>& directories);
+    // called from the background thread with the new @p contents of the indexed directory @p path
+    void update(const QString& path, bool exists, const Directory& contents);
+    // drops @p root and all directories below it; requires m_lock to be locked for writing
+    void removeTree(const QString& root, QStringList* removed);
+    bool isShuttingDown() const;
+
+    QReadWriteLock m_lock;
+    // absolute, clean directory path -> its contents
+    QHash<QString, Directory> m_directories;
+    // trees which are indexed or queued for indexing
+    QSet<QString> m_roots;
+    QThreadPool m_pool;
+    QAtomicInt m_shuttingDown;
+    QFileSystemWatcher* m_watcher;
+};
+
+}
+
+#endif // PYTHON_MODULEINDEX_H
@@ -0,0 +1,241 @@
+/*****************************************************************************
+ * This file is part of KDevelop                                             *
+ * Copyright 2026 agent <agent@local>                                        *
+ *                                                                           *
+ * This program is free software; you can redistribute it and/or             *
+ * modify it under the terms of the GNU General Public License as            *
+ * published by the Free Software Foundation; either version 2 of            *
+ * the License, or (at your option) any later version.                       *
+ *                                                                           *
+ * This program is distributed in the hope that it will be useful,           *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the             *
+ * GNU General Public License for more details.                              *
+ *                                                                           *
+ * You should have received a copy of the GNU General Public License         *
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.     *
+ *****************************************************************************
+ */
+
+#include "parseprofiler.h"
+
+#include <QElapsedTimer>
+#include <QFile>
+#include <QHash>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QTextStream>
+#include <QThread>
+
+#include <QDebug>
+#include "duchaindebug.h"
+
+namespace Python
+{
+
+namespace {
+struct Event {
+    QString file;
+    ParseProfiler::Phase phase;
+    qint64 start;
+    qint64 duration;
+    quintptr thread;
+};
+
+QMutex profileMutex;
+QVector<Event> events;
+QHash<QString, int> parseCounts;
+
+const QElapsedTimer& profileClock()
+{
+    static const QElapsedTimer timer = []() {
+        QElapsedTimer t;
+        t.start();
+        return t;
+    }();
+    return timer;
+}
+}
+
+bool ParseProfiler::isEnabled()
+{
+    static const bool enabled = qEnvironmentVariableIsSet("KDEV_PYTHON_PARSE_PROFILE");
+    return enabled;
+}
+
+QString ParseProfiler::phaseName(Phase phase)
+{
+    switch ( phase ) {
+        case ReadContents: return QStringLiteral("readContents");
+        case BuildAst: return QStringLiteral("buildAst");
+        case Prebuild: return QStringLiteral("prebuild");
+        case DeclarationBuild: return QStringLiteral("declarationBuild");
+        case UseBuild: return QStringLiteral("useBuild");
+        case Commit: return QStringLiteral("commit");
+        case Highlighting: return QStringLiteral("highlighting");
+        case PEP8: return QStringLiteral("pep8");
+        case LockWait: return QStringLiteral("lockWait");
+        case PhaseCount: break;
+    }
+    return QString();
+}
+
+qint64 ParseProfiler::now()
+{
+    return profileClock().nsecsElapsed();
+}
+
+void ParseProfiler::record(const QString& file, Phase phase, qint64 startNsecs, qint64 durationNsecs)
+{
+    if ( ! isEnabled() ) {
+        return;
+    }
+    const Event event{file, phase, startNsecs, durationNsecs, reinterpret_cast<quintptr>(QThread::currentThreadId())};
+    QMutexLocker lock(&profileMutex);
+    events.append(event);
+}
+
+void ParseProfiler::recordParse(const QString& file)
+{
+    if ( ! isEnabled() ) {
+        return;
+    }
+    QMutexLocker lock(&profileMutex);
+    parseCounts[file]++;
+}
+
+qint64 ParseProfiler::FileSummary::totalNsecs() const
+{
+    qint64 total = 0;
+    for ( int i = 0; i < PhaseCount; i++ ) {
+        // lock waits happen inside the other phases
+        if ( i != LockWait ) {
+            total += nsecs[i];
+        }
+    }
+    return total;
+}
+
+QVector<ParseProfiler::FileSummary> ParseProfiler::summary()
+{
+    QMutexLocker lock(&profileMutex);
+    QHash<QString, int> indexForFile;
+    QVector<FileSummary> result;
+    foreach ( const Event& event, events ) {
+        auto it = indexForFile.constFind(event.file);
+        int index = 0;
+        if ( it == indexForFile.constEnd() ) {
+            index = result.size();
+            indexForFile.insert(event.file, index);
+            FileSummary s;
+            s.file = event.file;
+            s.parses = parseCounts.value(event.file);
+            result.append(s);
+        }
+        else {
+            index = it.value();
+        }
+        result[index].nsecs[event.phase] += event.duration;
+    }
+    return result;
+}
+
+bool ParseProfiler::writeChromeTrace(const QString& path)
+{
+    QJsonArray traceEvents;
+    QHash<quintptr, int> threadIds;
+    {
+        QMutexLocker lock(&profileMutex);
+        foreach ( const Event& event, events ) {
+            if ( ! threadIds.contains(event.thread) ) {
+                threadIds.insert(event.thread, threadIds.size() + 1);
+            }
+            // complete events ("X"), timestamps are in microseconds
+            traceEvents.append(QJsonObject{
+                {"name", phaseName(event.phase)},
+                {"cat", "parse"},
+                {"ph", "X"},
+                {"ts", event.start / 1000.0},
+                {"dur", event.duration / 1000.0},
+                {"pid", 1},
+                {"tid", threadIds.value(event.thread)},
+                {"args", QJsonObject{{"file", event.file}}}
+            });
+        }
+    }
+    QFile f(path);
+    if ( ! f.open(QIODevice::WriteOnly | QIODevice::Truncate) ) {
+        qCWarning(KDEV_PYTHON_DUCHAIN) << "cannot write parse profile to" << path;
+        return false;
+    }
+    f.write(QJsonDocument(QJsonObject{{"traceEvents", traceEvents}}).toJson(QJsonDocument::Compact));
+    return true;
+}
+
+bool ParseProfiler::writeCsv(const QString& path)
+{
+    QFile f(path);
+    if ( ! f.open(QIODevice::WriteOnly | QIODevice::Truncate | QIODevice::Text) ) {
+        qCWarning(KDEV_PYTHON_DUCHAIN) << "cannot write parse profile to" << path;
+        return false;
+    }
+    QTextStream out(&f);
+    out << "file,parses";
+    for ( int i = 0; i < PhaseCount; i++ ) {
+        out << ',' << phaseName(static_cast<Phase>(i)) << "_ms";
+    }
+    out << ",total_ms\n";
+    foreach ( const FileSummary& s, summary() ) {
+        QString file = s.file;
+        out << '"' << file.replace('"', "\"\"") << '"' << ',' << s.parses;
+        for ( int i = 0; i < PhaseCount; i++ ) {
+            out << ',' << QString::number(s.nsecs[i] / 1e6, 'f', 3);
+        }
+        out << ',' << QString::number(s.totalNsecs() / 1e6, 'f', 3) << '\n';
+    }
+    return true;
+}
+
+void ParseProfiler::writeConfiguredOutput()
+{
+    if ( ! isEnabled() ) {
+        return;
+    }
+    const QString path = QString::fromLocal8Bit(qgetenv("KDEV_PYTHON_PARSE_PROFILE"));
+    if ( path.isEmpty() ) {
+        // profiling only for the in-process summary, e.g. by kdevpython-analyze
+        return;
+    }
+    if ( path.endsWith(QLatin1String(".csv"), Qt::CaseInsensitive) ) {
+        writeCsv(path);
+    }
+    else {
+        writeChromeTrace(path);
+    }
+}
+
+void ParseProfiler::reset()
+{
+    QMutexLocker lock(&profileMutex);
+    events.clear();
+    parseCounts.clear();
+}
+
+ParseProfilerScope::ParseProfilerScope(const QString& file, ParseProfiler::Phase phase)
+    : m_file(file)
+    , m_phase(phase)
+    , m_start(ParseProfiler::isEnabled() ? ParseProfiler::now() : 0)
+{
+}
+
+ParseProfilerScope::~ParseProfilerScope()
+{
+    if ( ParseProfiler::isEnabled() ) {
+        ParseProfiler::record(m_file, m_phase, m_start, ParseProfiler::now() - m_start);
+    }
+}
+
+}
@@ -0,0 +1,111 @@
+/*****************************************************************************
+ * This file is part of KDevelop                                             *
+ * Copyright 2026 agent <agent@local>                                        *
+ *                                                                           *
+ * This program is free software; you can redistribute it and/or             *
+ * modify it under the terms of the GNU General Public License as            *
+ * published by the Free Software Foundation; either version 2 of            *
+ * the License, or (at your option) any later version.                       *
+ *                                                                           *
+ * This program is distributed in the hope that it will be useful,           *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the             *
+ * GNU General Public License for more details.                              *
+ *                                                                           *
+ * You should have received a copy of the GNU General Public License         *
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.     *
+ *****************************************************************************
+ */
+
+#ifndef PYTHON_PARSEPROFILER_H
+#define PYTHON_PARSEPROFILER_H
+
+#include <QString>
+#include <QVector>
+
+#include "pythonduchainexport.h"
+
+namespace Python
+{
+
+/**
+ * @brief Records how long each phase of parsing a file takes.
+ *
+ * Recording is enabled by setting KDEV_PYTHON_PARSE_PROFILE to an output file name. When the plugin
+ * is unloaded, the data is written there: as a per-file CSV summary if the name ends in ".csv",
+ * and as a Chrome trace (to be loaded in chrome://tracing) otherwise.
+ * Setting the variable also enables LockStatistics, which provides the lock wait times. The LockWait phase
+ * is the time the parse job and the builders spent waiting for the DUChain lock, and for the Python
+ * interpreter lock; locks taken inside KDevelop itself (e.g. by the highlighting) are not included.
+ */
+class KDEVPYTHONDUCHAIN_EXPORT ParseProfiler
+{
+public:
+    enum Phase {
+        ReadContents,
+        BuildAst,
+        Prebuild,
+        DeclarationBuild,
+        UseBuild,
+        Commit,
+        Highlighting,
+        PEP8,
+        LockWait,
+        PhaseCount
+    };
+
+    struct FileSummary {
+        QString file;
+        int parses = 0;
+        qint64 nsecs[PhaseCount] = {};
+        qint64 totalNsecs() const;
+    };
+
+    static bool isEnabled();
+    static QString phaseName(Phase phase);
+
+    /// Nanoseconds since the profiler was first used; the time base for record()
+    static qint64 now();
+
+    /**
+     * @brief Record that @p phase took @p durationNsecs for @p file, starting at @p startNsecs.
+     */
+    static void record(const QString& file, Phase phase, qint64 startNsecs, qint64 durationNsecs);
+
+    /**
+     * @brief Record that another parse of @p file finished; used to count parses per file.
+     */
+    static void recordParse(const QString& file);
+
+    /// Recorded times summed up per file, in no particular order
+    static QVector<FileSummary> summary();
+
+    static bool writeChromeTrace(const QString& path);
+    static bool writeCsv(const QString& path);
+
+    /**
+     * @brief Write the recorded data to the file given in KDEV_PYTHON_PARSE_PROFILE, unless it is empty.
+     */
+    static void writeConfiguredOutput();
+
+    static void reset();
+};
+
+/**
+ * @brief Records the time between its construction and destruction as @p phase of parsing @p file.
+ */
+class KDEVPYTHONDUCHAIN_EXPORT ParseProfilerScope
+{
+public:
+    ParseProfilerScope(const QString& file, ParseProfiler::Phase phase);
+    ~ParseProfilerScope();
+
+private:
+    const QString m_file;
+    ParseProfiler::Phase m_phase;
+    qint64 m_start;
+};
+
+}
+
+#endif // PYTHON_PARSEPROFILER_H
@@ -0,0 +1,63 @@
+/*****************************************************************************
+ * This file is part of KDevelop                                             *
+ * Copyright 2026 agent <agent@local>                                        *
+ *                                                                           *
+ * This program is free software; you can redistribute it and/or             *
+ * modify it under the terms of the GNU General Public License as            *
+ * published by the Free Software Foundation; either version 2 of            *
+ * the License, or (at your option) any later version.                       *
+ *                                                                           *
+ * This program is distributed in the hope that it will be useful,           *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the             *
+ * GNU General Public License for more details.                              *
+ *                                                                           *
+ * You should have received a copy of the GNU General Public License         *
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.     *
+ *****************************************************************************
+ */
+
+#include "projectpaths.h"
+
+#include <memory>
+
+namespace Python
+{
+
+namespace {
+struct Snapshot {
+    QVector<ProjectPaths::Project> projects;
+    QList<QUrl> roots;
+};
+
+// only ever accessed with std::atomic_load / std::atomic_store
+std::shared_ptr<const Snapshot> current = std::make_shared<const Snapshot>();
+}
+
+void ProjectPaths::update(const QVector<Project>& projects)
+{
+    auto snapshot = std::make_shared<Snapshot>();
+    snapshot->projects = projects;
+    foreach ( const Project& project, projects ) {
+        snapshot->roots.append(project.root);
+    }
+    std::atomic_store(&current, std::shared_ptr<const Snapshot>(snapshot));
+}
+
+QList<QUrl> ProjectPaths::searchPaths(const QUrl& document)
+{
+    const auto snapshot = std::atomic_load(&current);
+    QList<QUrl> paths = snapshot->roots;
+    if ( document.isEmpty() ) {
+        return paths;
+    }
+    foreach ( const Project& project, snapshot->projects ) {
+        if ( project.root.isParentOf(document) ) {
+            paths.append(project.includes);
+            break;
+        }
+    }
+    return paths;
+}
+
+}
@@ -0,0 +1,61 @@
+/*****************************************************************************
+ * This file is part of KDevelop                                             *
+ * Copyright 2026 agent <agent@local>                                        *
+ *                                                                           *
+ * This program is free software; you can redistribute it and/or             *
+ * modify it under the terms of the GNU General Public License as            *
+ * published by the Free Software Foundation; either version 2 of            *
+ * the License, or (at your option) any later version.                       *
+ *                                                                           *
+ * This program is distributed in the hope that it will be useful,           *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the             *
+ * GNU General Public License for more details.                              *
+ *                                                                           *
+ * You should have received a copy of the GNU General Public License         *
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.     *
+ *****************************************************************************
+ */
+
+#ifndef PYTHON_PROJECTPATHS_H
+#define PYTHON_PROJECTPATHS_H
+
+#include <QList>
+#include <QUrl>
+#include <QVector>
+
+#include "pythonduchainexport.h"
+
+namespace Python
+{
+
+/**
+ * @brief The open projects' directories and custom include paths, as used for resolving imports.
+ *
+ * The paths are published as an immutable snapshot whenever a project is opened, closed or reconfigured,
+ * so parse jobs can read them without taking a lock or asking the project controller.
+ */
+class KDEVPYTHONDUCHAIN_EXPORT ProjectPaths
+{
+public:
+    struct Project {
+        QUrl root;
+        /// user-defined include paths from the project's configuration
+        QList<QUrl> includes;
+    };
+
+    /**
+     * @brief Replace the current snapshot with @p projects.
+     */
+    static void update(const QVector<Project>& projects);
+
+    /**
+     * @brief The directories of all open projects, followed by the include paths of the project
+     * @p document belongs to, if any.
+     */
+    static QList<QUrl> searchPaths(const QUrl& document);
+};
+
+}
+
+#endif // PYTHON_PROJECTPATHS_H
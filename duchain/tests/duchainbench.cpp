@@ -34,6 +34,7 @@
 #include <QtTest/QtTest>
 #include <language/backgroundparser/backgroundparser.h>
 #include <interfaces/ilanguagecontroller.h>
+#include <QFile>
 #include <QStandardPaths>
 
 #include "parsesession.h"
@@ -49,6 +50,7 @@ DUChainBench::DUChainBench(QObject* parent): QObject(parent)
     testDir = QDir(testDirOwner.path());
 
     initShell();
+    createSupportModules();
 }
 
 
@@ -102,6 +104,44 @@ QString repeat_distinct(const QString& code, int count) {
     return result;
 }
 
+void DUChainBench::createSupportModules()
+{
+    QString base = "class Base0(object):\n    def __init__(self):\n        self.value = 0\n        self.child = None\n";
+    for ( int i = 1; i < 20; i++ ) {
+        base.append(QString("class Base%1(Base%2):\n"
+                            "    def __init__(self):\n"
+                            "        self.child = Base%2()\n"
+                            "        self.name%1 = 'base'\n"
+                            "    def method%1(self, arg):\n"
+                            "        return self.child\n").arg(i).arg(i - 1));
+    }
+    QString utils;
+    for ( int i = 0; i < 100; i++ ) {
+        utils.append(QString("def util%1(a, b=%1):\n    return [a, b]\nCONSTANT%1 = %1\n").arg(i));
+    }
+    QString star = "__all__ = [" + repeat_distinct("'exported%X', ", 50) + "]\n" + repeat_distinct("exported%X = %X\n", 100);
+
+    const QList<QPair<QString, QString>> modules{
+        {"benchbase.py", base},
+        {"benchutils.py", utils},
+        {"benchstar.py", star}
+    };
+    QList<IndexedString> urls;
+    for ( const auto& module : modules ) {
+        const QString path = testDir.absoluteFilePath(module.first);
+        QFile f(path);
+        f.open(QIODevice::WriteOnly);
+        f.write(module.second.toUtf8());
+        f.close();
+        urls << IndexedString(QUrl::fromLocalFile(path));
+        DUChain::self()->updateContextForUrl(urls.last(), KDevelop::TopDUContext::AllDeclarationsContextsAndUses);
+    }
+    ICore::self()->languageController()->backgroundParser()->parseDocuments();
+    foreach ( const IndexedString& url, urls ) {
+        DUChain::self()->waitForUpdate(url, KDevelop::TopDUContext::AllDeclarationsContextsAndUses);
+    }
+}
+
 void DUChainBench::benchSimpleStatements_data()
 {
     QTest::addColumn<QString>("code");
@@ -132,3 +172,47 @@ void DUChainBench::benchSimpleStatements()
         parse(code);
     }
 }
+
+void DUChainBench::benchRealisticCode_data()
+{
+    QTest::addColumn<QString>("code");
+
+    // the modules imported here are created by createSupportModules()
+    QTest::newRow("class_hierarchy_attribute_chains") << "from benchbase import *\n" +
+        repeat_distinct("class Derived%X(Base19):\n"
+                        "    def run(self):\n"
+                        "        a%X = self.child.child.child.child.child.value\n"
+                        "        b%X = self.method19(3).method18(4).name17\n"
+                        "        return self.child.child.name17\n"
+                        "x%X = Derived%X().run()\n", 40);
+    QTest::newRow("cross_module_imports") <<
+        repeat_distinct("import benchutils\nfrom benchutils import util%X, CONSTANT%X\n"
+                        "from benchbase import Base%X\n", 20) +
+        repeat_distinct("r%X = benchutils.util%X(CONSTANT%X)\ns%X = util%X(benchutils.CONSTANT%X)[0]\n", 20);
+    QTest::newRow("star_imports") << "from benchstar import *\nfrom benchutils import *\nfrom os.path import *\n" +
+        repeat_distinct("v%X = exported%X + CONSTANT%X\nw%X = util%X(join('a', 'b'))\n", 50);
+    QTest::newRow("decorator_hinted_calls") <<
+        repeat_distinct("l%X = []\nl%X.append(%X)\nx%X = l%X.pop()\n"
+                        "d%X = {}\nd%X['a'] = 'b'\ny%X = d%X.get('a')\nz%X = ' '.join(d%X.keys())\n"
+                        "for k%X, v%X in d%X.items():\n    pass\n", 50);
+    QTest::newRow("huge_literal_containers") <<
+        "data = {" + repeat_distinct("'key%X': [%X, 'value', (%X, 1.5)], ", 1000) + "}\n" +
+        "table = [" + repeat_distinct("(%X, 'name%X', None), ", 1000) + "]\n";
+    QTest::newRow("comprehensions") <<
+        repeat_distinct("c%X = [x * y for x in range(%X) for y in range(x) if x != y]\n"
+                        "d%X = {str(k): [v for v in range(k)] for k in c%X}\n"
+                        "e%X = sum(len(v) for v in d%X.values())\n"
+                        "f%X = {(a, b) for a, b in zip(c%X, c%X[1:])}\n", 50);
+    QTest::newRow("syntax_errors") <<
+        repeat_distinct("def func%X(a, b):\n    return a + b\n"
+                        "x%X = func%X(1, \n"
+                        "class Broken%X(:\n    pass\n", 30);
+}
+
+void DUChainBench::benchRealisticCode()
+{
+    QFETCH(QString, code);
+    QBENCHMARK {
+        parse(code);
+    }
+}
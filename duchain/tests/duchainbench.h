@@ -53,8 +53,13 @@ public:
 private slots:
     void benchSimpleStatements();
     void benchSimpleStatements_data();
+    void benchRealisticCode();
+    void benchRealisticCode_data();
 
 private:
+    /// Write the modules imported by the realistic code benchmarks to the test directory, and parse them.
+    void createSupportModules();
+
     QList<KDevelop::TestFile*> createdFiles;
     QDir testDir;
     QTemporaryDir testDirOwner;
@@ -0,0 +1,241 @@
+/*****************************************************************************
+ * This file is part of KDevelop                                             *
+ * Copyright 2026 agent <agent@local>                                        *
+ *                                                                           *
+ * This program is free software; you can redistribute it and/or             *
+ * modify it under the terms of the GNU General Public License as            *
+ * published by the Free Software Foundation; either version 2 of            *
+ * the License, or (at your option) any later version.                       *
+ *                                                                           *
+ * This program is distributed in the hope that it will be useful,           *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the             *
+ * GNU General Public License for more details.                              *
+ *                                                                           *
+ * You should have received a copy of the GNU General Public License         *
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.     *
+ *****************************************************************************
+ */
+
+/*
+ * kdevpython-analyze: parse all python files in a directory the same way the IDE does
+ * (through the background parser and the plugin's parse jobs), and report how long it took.
+ * Meant to be run regularly against a big code base, to notice indexing time regressions.
+ */
+
+#include <QApplication>
+#include <QCommandLineParser>
+#include <QDir>
+#include <QDirIterator>
+#include <QElapsedTimer>
+#include <QEventLoop>
+#include <QSet>
+#include <QTextStream>
+#include <QThread>
+#include <QTimer>
+
+#include <language/backgroundparser/backgroundparser.h>
+#include <language/backgroundparser/parsejob.h>
+#include <language/duchain/duchain.h>
+#include <language/duchain/duchainlock.h>
+#include <language/duchain/topducontext.h>
+#include <interfaces/ilanguagecontroller.h>
+#include <tests/autotestshell.h>
+#include <tests/testcore.h>
+
+#include "helpers.h"
+#include "parseprofiler.h"
+#include "projectpaths.h"
+
+#include <algorithm>
+
+#ifdef Q_OS_UNIX
+#include <sys/resource.h>
+#endif
+
+using namespace KDevelop;
+using namespace Python;
+
+namespace {
+
+// peak resident set size in MiB, or -1 if unknown on this platform
+double peakResidentMemory()
+{
+#ifdef Q_OS_UNIX
+    rusage usage;
+    if ( getrusage(RUSAGE_SELF, &usage) == 0 ) {
+#ifdef Q_OS_MAC
+        return usage.ru_maxrss / 1024.0 / 1024.0;
+#else
+        return usage.ru_maxrss / 1024.0;
+#endif
+    }
+#endif
+    return -1;
+}
+
+void wait(int msecs)
+{
+    QEventLoop loop;
+    QTimer::singleShot(msecs, &loop, SLOT(quit()));
+    loop.exec();
+}
+
+}
+
+int main(int argc, char** argv)
+{
+    // the parse profiler provides the per-file times; it must be enabled before the plugin is loaded.
+    // An empty value means that nothing is written to disk, unless requested below.
+    if ( ! qEnvironmentVariableIsSet("KDEV_PYTHON_PARSE_PROFILE") ) {
+        qputenv("KDEV_PYTHON_PARSE_PROFILE", QByteArray());
+    }
+    if ( ! qEnvironmentVariableIsSet("QT_QPA_PLATFORM") ) {
+        qputenv("QT_QPA_PLATFORM", "offscreen");
+    }
+
+    QApplication app(argc, argv);
+    QCoreApplication::setApplicationName(QStringLiteral("kdevpython-analyze"));
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription(QStringLiteral("Index all python files in a directory with kdev-python, and report timing statistics."));
+    parser.addHelpOption();
+    parser.addPositionalArgument(QStringLiteral("directory"), QStringLiteral("The directory to analyze."));
+    QCommandLineOption threadsOption({QStringLiteral("j"), QStringLiteral("threads")},
+                                     QStringLiteral("Number of parser threads."), QStringLiteral("count"),
+                                     QString::number(QThread::idealThreadCount()));
+    QCommandLineOption outliersOption(QStringLiteral("outliers"),
+                                      QStringLiteral("Number of slowest files to list."), QStringLiteral("count"),
+                                      QStringLiteral("10"));
+    QCommandLineOption timeoutOption(QStringLiteral("timeout"),
+                                     QStringLiteral("Give up after this many seconds."), QStringLiteral("seconds"),
+                                     QStringLiteral("3600"));
+    QCommandLineOption csvOption(QStringLiteral("csv"),
+                                 QStringLiteral("Write per-file, per-phase times to this CSV file."), QStringLiteral("file"));
+    parser.addOption(threadsOption);
+    parser.addOption(outliersOption);
+    parser.addOption(timeoutOption);
+    parser.addOption(csvOption);
+    parser.process(app);
+
+    QTextStream out(stdout);
+    if ( parser.positionalArguments().size() != 1 ) {
+        parser.showHelp(1);
+    }
+    const QDir directory(parser.positionalArguments().first());
+    if ( ! directory.exists() ) {
+        out << "directory does not exist: " << directory.path() << endl;
+        return 1;
+    }
+    const int threads = qMax(1, parser.value(threadsOption).toInt());
+    const int outliers = qMax(0, parser.value(outliersOption).toInt());
+    const qint64 timeout = parser.value(timeoutOption).toLongLong() * 1000;
+
+    QList<IndexedString> files;
+    QDirIterator it(directory.absolutePath(), {QStringLiteral("*.py")}, QDir::Files, QDirIterator::Subdirectories);
+    while ( it.hasNext() ) {
+        files.append(IndexedString(QUrl::fromLocalFile(QDir::cleanPath(it.next()))));
+    }
+    if ( files.isEmpty() ) {
+        out << "no python files found in " << directory.path() << endl;
+        return 1;
+    }
+
+    AutoTestShell::init();
+    TestCore* core = new TestCore();
+    core->initialize(KDevelop::Core::NoUi);
+    DUChain::self()->disablePersistentStorage();
+
+    auto bgparser = ICore::self()->languageController()->backgroundParser();
+    bgparser->setThreadCount(threads);
+    bgparser->setDelay(0);
+
+    // The built-in documentation is imported by every file; parse it first, and don't count it.
+    const IndexedString documentation(Helper::getDocumentationFile());
+    DUChain::self()->updateContextForUrl(documentation, TopDUContext::AllDeclarationsContextsAndUses);
+    bgparser->parseDocuments();
+    DUChain::self()->waitForUpdate(documentation, TopDUContext::AllDeclarationsContextsAndUses);
+    ParseProfiler::reset();
+
+    // Like a project opened in the IDE, the analyzed directory is a search path for imports.
+    // The plugin was loaded to parse the documentation above, and there are no projects in this
+    // process which could make it replace this snapshot later on.
+    ProjectPaths::Project root;
+    root.root = QUrl::fromLocalFile(directory.absolutePath());
+    ProjectPaths::update({root});
+
+    QSet<IndexedString> pending = files.toSet();
+    QObject::connect(bgparser, &BackgroundParser::parseJobFinished, [&pending](KDevelop::ParseJob* job) {
+        pending.remove(job->document());
+    });
+
+    out << "analyzing " << files.size() << " files with " << threads << " threads" << endl;
+    QElapsedTimer timer;
+    timer.start();
+    foreach ( const IndexedString& file, files ) {
+        bgparser->addDocument(file, TopDUContext::AllDeclarationsContextsAndUses, BackgroundParser::InitialParsePriority);
+    }
+    bgparser->parseDocuments();
+
+    // files can be re-scheduled after their imports were parsed, so also wait for the queue to drain
+    bool timedOut = false;
+    while ( ! pending.isEmpty() || bgparser->queuedCount() > 0 ) {
+        if ( timer.elapsed() > timeout ) {
+            timedOut = true;
+            break;
+        }
+        wait(20);
+    }
+    const qint64 elapsed = timer.elapsed();
+
+    int problems = 0;
+    int filesWithProblems = 0;
+    int filesWithoutContext = 0;
+    {
+        DUChainReadLocker lock;
+        foreach ( const IndexedString& file, files ) {
+            const TopDUContext* top = DUChain::self()->chainForDocument(file);
+            if ( ! top ) {
+                filesWithoutContext++;
+                continue;
+            }
+            const int count = top->problems().size();
+            problems += count;
+            filesWithProblems += count > 0;
+        }
+    }
+
+    auto summary = ParseProfiler::summary();
+    std::sort(summary.begin(), summary.end(), [](const ParseProfiler::FileSummary& a, const ParseProfiler::FileSummary& b) {
+        return a.totalNsecs() > b.totalNsecs();
+    });
+    int parses = 0;
+    foreach ( const ParseProfiler::FileSummary& s, summary ) {
+        parses += s.parses;
+    }
+
+    out << "files:               " << files.size() << endl;
+    out << "parse jobs:          " << parses << endl;
+    out << "wall time:           " << QString::number(elapsed / 1000.0, 'f', 2) << " s" << endl;
+    out << "files/s:             " << QString::number(files.size() * 1000.0 / qMax<qint64>(elapsed, 1), 'f', 1) << endl;
+    out << "peak RSS:            " << QString::number(peakResidentMemory(), 'f', 1) << " MiB" << endl;
+    out << "problems:            " << problems << " in " << filesWithProblems << " files" << endl;
+    out << "files without duchain: " << filesWithoutContext << endl;
+    if ( outliers > 0 && ! summary.isEmpty() ) {
+        out << endl << "slowest files (ms, summed over all parses of the file):" << endl;
+        for ( int i = 0; i < qMin(outliers, summary.size()); i++ ) {
+            const auto& s = summary.at(i);
+            out << QString::number(s.totalNsecs() / 1e6, 'f', 1).rightJustified(10) << "  "
+                << s.parses << "x  " << directory.relativeFilePath(s.file) << endl;
+        }
+    }
+    if ( parser.isSet(csvOption) && ! ParseProfiler::writeCsv(parser.value(csvOption)) ) {
+        out << "could not write " << parser.value(csvOption) << endl;
+    }
+    if ( timedOut ) {
+        out << "timed out, " << pending.size() << " files were not parsed" << endl;
+    }
+
+    TestCore::shutdown();
+    return timedOut ? 2 : 0;
+}
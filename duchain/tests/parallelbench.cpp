@@ -0,0 +1,217 @@
+/*****************************************************************************
+ * This file is part of KDevelop                                             *
+ * Copyright 2026 agent <agent@local>                                        *
+ *                                                                           *
+ * This program is free software; you can redistribute it and/or             *
+ * modify it under the terms of the GNU General Public License as            *
+ * published by the Free Software Foundation; either version 2 of            *
+ * the License, or (at your option) any later version.                       *
+ *                                                                           *
+ * This program is distributed in the hope that it will be useful,           *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the             *
+ * GNU General Public License for more details.                              *
+ *                                                                           *
+ * You should have received a copy of the GNU General Public License         *
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.     *
+ *****************************************************************************
+ */
+
+#include "parallelbench.h"
+
+#include <QDebug>
+#include <QElapsedTimer>
+#include <QEventLoop>
+#include <QFile>
+#include <QSet>
+#include <QStandardPaths>
+#include <QTextStream>
+#include <QThread>
+#include <QTimer>
+#include <QtTest/QtTest>
+
+#include <language/backgroundparser/backgroundparser.h>
+#include <language/backgroundparser/parsejob.h>
+#include <language/codegen/coderepresentation.h>
+#include <language/duchain/duchain.h>
+#include <language/duchain/topducontext.h>
+#include <interfaces/ilanguagecontroller.h>
+#include <tests/autotestshell.h>
+#include <tests/testcore.h>
+
+#include "lockstatistics.h"
+
+#ifdef Q_OS_UNIX
+#include <sys/resource.h>
+#endif
+
+QTEST_MAIN(ParallelBench)
+
+using namespace KDevelop;
+using namespace Python;
+
+namespace {
+// user + system CPU time of the whole process, in milliseconds
+double processCpuTime()
+{
+#ifdef Q_OS_UNIX
+    rusage usage;
+    if ( getrusage(RUSAGE_SELF, &usage) == 0 ) {
+        return usage.ru_utime.tv_sec * 1000.0 + usage.ru_utime.tv_usec / 1000.0
+             + usage.ru_stime.tv_sec * 1000.0 + usage.ru_stime.tv_usec / 1000.0;
+    }
+#endif
+    return 0;
+}
+}
+
+ParallelBench::ParallelBench(QObject* parent)
+    : QObject(parent)
+{
+    // must be set before the first lock is measured, the setting is only read once
+    qputenv("KDEV_PYTHON_LOCK_STATISTICS", "1");
+}
+
+void ParallelBench::initTestCase()
+{
+    AutoTestShell::init();
+    TestCore* core = new TestCore();
+    core->initialize(KDevelop::Core::NoUi);
+
+    auto doc_url = QDir::cleanPath(QStandardPaths::locate(QStandardPaths::GenericDataLocation,
+                                                          "kdevpythonsupport/documentation_files/builtindocumentation.py"));
+
+    DUChain::self()->updateContextForUrl(IndexedString(doc_url), KDevelop::TopDUContext::AllDeclarationsContextsAndUses);
+    ICore::self()->languageController()->backgroundParser()->parseDocuments();
+    DUChain::self()->waitForUpdate(IndexedString(doc_url), KDevelop::TopDUContext::AllDeclarationsContextsAndUses);
+
+    DUChain::self()->disablePersistentStorage();
+    KDevelop::CodeRepresentation::setDiskChangesForbidden(true);
+}
+
+void ParallelBench::cleanupTestCase()
+{
+    qDeleteAll(m_corpusDirs);
+    TestCore::shutdown();
+}
+
+QList<IndexedString> ParallelBench::createCorpus(const QString& directory, int count)
+{
+    QList<IndexedString> files;
+    for ( int i = 0; i < count; i++ ) {
+        QString code;
+        QTextStream s(&code);
+        // Each module imports two modules with a lower number, so there are long import chains,
+        // but also many modules which can be parsed at the same time.
+        const int base = i / 2;
+        const int other = i / 3;
+        if ( i > 0 ) {
+            s << "from mod" << base << " import Class" << base << ", func" << base << "\n";
+            s << "import mod" << other << "\n";
+        }
+        s << "\n";
+        for ( int c = 0; c < 5; c++ ) {
+            s << "class Class" << i << (c ? QString::number(c) : QString())
+              << "(" << ( i > 0 ? QStringLiteral("Class%1").arg(base) : QStringLiteral("object") ) << "):\n";
+            s << "    def __init__(self, value):\n";
+            s << "        self.value = value\n";
+            s << "        self.items = [x * 2 for x in range(value)]\n";
+            s << "        self.names = {str(x): x for x in self.items}\n";
+            for ( int m = 0; m < 6; m++ ) {
+                s << "    def method" << m << "(self, arg):\n";
+                s << "        if arg > " << m << ":\n";
+                s << "            return self.items[" << m << "] + arg\n";
+                s << "        return self.names.get(str(arg), " << m << ")\n";
+            }
+            s << "\n";
+        }
+        s << "def func" << i << "(x):\n";
+        s << "    instance = Class" << i << "(x)\n";
+        if ( i > 0 ) {
+            s << "    parent = func" << base << "(x)\n";
+            s << "    other = mod" << other << ".func" << other << "(x)\n";
+        }
+        s << "    return instance\n";
+        s.flush();
+
+        const QString path = directory + QStringLiteral("/mod%1.py").arg(i);
+        QFile f(path);
+        f.open(QIODevice::WriteOnly);
+        f.write(code.toUtf8());
+        files.append(IndexedString(QUrl::fromLocalFile(path)));
+    }
+    return files;
+}
+
+void ParallelBench::benchParallelParsing_data()
+{
+    QTest::addColumn<int>("threads");
+
+    QList<int> counts{1, 2, 4};
+    if ( QThread::idealThreadCount() > 4 ) {
+        counts << QThread::idealThreadCount();
+    }
+    foreach ( int count, counts ) {
+        QTest::newRow(qPrintable(QStringLiteral("threads_%1").arg(count))) << count;
+    }
+}
+
+void ParallelBench::benchParallelParsing()
+{
+    QFETCH(int, threads);
+
+    // a new corpus for each run, so no module is in the duchain yet
+    auto dir = new QTemporaryDir;
+    m_corpusDirs << dir;
+    const auto files = createCorpus(dir->path(), 120);
+
+    auto bgparser = ICore::self()->languageController()->backgroundParser();
+    const int previousThreadCount = bgparser->threadCount();
+    bgparser->setThreadCount(threads);
+    bgparser->setDelay(0);
+
+    QSet<IndexedString> pending = files.toSet();
+    auto connection = QObject::connect(bgparser, &BackgroundParser::parseJobFinished, [&pending](KDevelop::ParseJob* job) {
+        pending.remove(job->document());
+    });
+
+    LockStatistics::reset();
+    const double cpuStart = processCpuTime();
+    QElapsedTimer timer;
+    timer.start();
+    foreach ( const IndexedString& file, files ) {
+        bgparser->addDocument(file, TopDUContext::AllDeclarationsContextsAndUses, BackgroundParser::InitialParsePriority);
+    }
+    bgparser->parseDocuments();
+    // files can be re-scheduled after their imports were parsed, so also wait for the queue to drain
+    while ( ! pending.isEmpty() || bgparser->queuedCount() > 0 ) {
+        QVERIFY2(timer.elapsed() < 300000, "Timed out waiting for parser results");
+        QEventLoop loop;
+        QTimer::singleShot(10, &loop, SLOT(quit()));
+        loop.exec();
+    }
+    const qint64 wallTime = timer.elapsed();
+    const double cpuTime = processCpuTime() - cpuStart;
+
+    QObject::disconnect(connection);
+    bgparser->setThreadCount(previousThreadCount);
+
+    QTest::setBenchmarkResult(wallTime, QTest::WalltimeMilliseconds);
+    qDebug().noquote() << threads << "threads:" << wallTime << "ms wall time,"
+                       << cpuTime << "ms cpu time, utilization" << QString::number(cpuTime / qMax<qint64>(wallTime, 1), 'f', 2)
+                       << "of" << threads << "threads";
+    // the DUChain lock is taken by the builders, the parse jobs and the commit phase, each recorded separately
+    qint64 duchainWait = 0;
+    quint64 duchainAcquisitions = 0;
+    const auto statistics = LockStatistics::snapshot();
+    for ( auto it = statistics.constBegin(); it != statistics.constEnd(); it++ ) {
+        if ( it.key().startsWith("DUChain") ) {
+            duchainWait += it->waitNsecs;
+            duchainAcquisitions += it->acquisitions;
+        }
+    }
+    qDebug().noquote() << "DUChain lock:" << duchainAcquisitions << "acquisitions," << duchainWait / 1000000 << "ms total wait,"
+                       << QString::number(duchainWait / 1e6 / qMax<qint64>(wallTime * threads, 1) * 100, 'f', 1)
+                       << "% of the parser threads' time";
+    qDebug().noquote() << LockStatistics::summary();
+}
@@ -0,0 +1,53 @@
+/*****************************************************************************
+ * This file is part of KDevelop                                             *
+ * Copyright 2026 agent <agent@local>                                        *
+ *                                                                           *
+ * This program is free software; you can redistribute it and/or             *
+ * modify it under the terms of the GNU General Public License as            *
+ * published by the Free Software Foundation; either version 2 of            *
+ * the License, or (at your option) any later version.                       *
+ *                                                                           *
+ * This program is distributed in the hope that it will be useful,           *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the             *
+ * GNU General Public License for more details.                              *
+ *                                                                           *
+ * You should have received a copy of the GNU General Public License         *
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.     *
+ *****************************************************************************
+ */
+
+#ifndef PY_PARALLELBENCH_H
+#define PY_PARALLELBENCH_H
+
+#include <QObject>
+#include <QTemporaryDir>
+
+#include <serialization/indexedstring.h>
+
+/**
+ * @brief Parses a corpus of modules which import each other with different numbers of parser threads.
+ *
+ * Besides the wall time, the CPU utilization and the time spent waiting for the instrumented locks
+ * (see Python::LockStatistics) are reported, to see where parallel parsing gets serialized. The DUChain
+ * lock waits of the builders, the parse jobs and their commit phase are also reported as one total.
+ */
+class ParallelBench : public QObject
+{
+    Q_OBJECT
+public:
+    explicit ParallelBench(QObject* parent = 0);
+
+private slots:
+    void initTestCase();
+    void cleanupTestCase();
+    void benchParallelParsing_data();
+    void benchParallelParsing();
+
+private:
+    /// Write @p count interdependent modules into @p directory, and return their names.
+    QList<KDevelop::IndexedString> createCorpus(const QString& directory, int count);
+    QList<QTemporaryDir*> m_corpusDirs;
+};
+
+#endif // PY_PARALLELBENCH_H
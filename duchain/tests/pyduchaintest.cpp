@@ -34,6 +34,7 @@
 #include <tests/autotestshell.h>
 #include <tests/testcore.h>
 #include <language/duchain/duchain.h>
+#include <language/duchain/parsingenvironment.h>
 #include <QtTest/QtTest>
 #include <QtWidgets/QApplication>
 #include <language/duchain/types/functiontype.h>
@@ -54,6 +55,8 @@
 #include "expressionvisitor.h"
 #include "contextbuilder.h"
 #include "astbuilder.h"
+#include "importgraph.h"
+#include "moduleindex.h"
 
 #include "duchain/helpers.h"
 
@@ -242,6 +245,176 @@ void PyDUChainTest::testImportFiles() {
     QCOMPARE(p.first()->abstractType()->toString(), QString("fromOther"));
 }
 
+void PyDUChainTest::testImportFilesOnlyAccessed() {
+    QString code = "import testImportFiles\np = testImportFiles.other.fromOther()";
+    ReferencedTopDUContext ctx = parse(code.toUtf8());
+    DUChainReadLocker lock;
+    QVERIFY(ctx);
+
+    auto package = ctx->findDeclarations(QualifiedIdentifier("testImportFiles"));
+    QCOMPARE(package.size(), 1);
+    auto packageContext = package.first()->internalContext();
+    QVERIFY(packageContext);
+    // only the submodule which is accessed in the document is resolved, the other one is a placeholder
+    auto other = packageContext->findLocalDeclarations(KDevelop::Identifier("other"));
+    QCOMPARE(other.size(), 1);
+    QVERIFY(other.first()->internalContext());
+    auto other2 = packageContext->findLocalDeclarations(KDevelop::Identifier("other2"));
+    QCOMPARE(other2.size(), 1);
+    QVERIFY(! other2.first()->internalContext());
+}
+
+void PyDUChainTest::testImportGraphScan() {
+    QFETCH(QString, code);
+    QFETCH(QStringList, modules);
+    QCOMPARE(Python::ImportGraph::scanImports(code), modules);
+}
+
+void PyDUChainTest::testImportGraphScan_data() {
+    QTest::addColumn<QString>("code");
+    QTest::addColumn<QStringList>("modules");
+
+    QTest::newRow("import") << "import os" << QStringList{"os"};
+    QTest::newRow("import_multiple") << "import os.path as p, sys" << QStringList{"os.path", "sys"};
+    QTest::newRow("from") << "from a.b import c as d, e" << QStringList{"a.b", "a.b.c", "a.b.e"};
+    QTest::newRow("from_star") << "from a import *" << QStringList{"a"};
+    QTest::newRow("relative") << "from . import sibling" << QStringList{".sibling"};
+    QTest::newRow("relative_module") << "from ..pkg import x" << QStringList{"..pkg", "..pkg.x"};
+    QTest::newRow("indented") << "def f():\n    import json\nx = 3" << QStringList{"json"};
+    QTest::newRow("no_import") << "important = 3" << QStringList{};
+}
+
+void PyDUChainTest::testImportGraphLevels() {
+    const auto file = [](const char* name) { return QUrl::fromLocalFile(QString("/tmp/") + name + ".py"); };
+    Python::ImportGraph graph;
+    for ( const char* name : {"leaf", "a", "b", "c", "top", "single"} ) {
+        graph.addFile(file(name));
+    }
+    // a and b import each other, c imports both, top imports c and the leaf
+    graph.addDependency(file("a"), file("leaf"));
+    graph.addDependency(file("a"), file("b"));
+    graph.addDependency(file("b"), file("a"));
+    graph.addDependency(file("c"), file("a"));
+    graph.addDependency(file("c"), file("b"));
+    graph.addDependency(file("top"), file("c"));
+    graph.addDependency(file("top"), file("leaf"));
+
+    const auto levels = graph.levels();
+    QCOMPARE(levels.size(), 6);
+    QCOMPARE(levels[file("leaf")], 0);
+    QCOMPARE(levels[file("single")], 0);
+    QCOMPARE(levels[file("a")], 1);
+    QCOMPARE(levels[file("b")], 1);
+    QCOMPARE(levels[file("c")], 2);
+    QCOMPARE(levels[file("top")], 3);
+}
+
+void PyDUChainTest::testModuleIndex() {
+    QTemporaryDir rootOwner;
+    const QString root = QDir(rootOwner.path()).absolutePath();
+    const auto touch = [&root](const QString& path) {
+        QFileInfo info(root + "/" + path);
+        QDir().mkpath(info.absolutePath());
+        QFile file(info.absoluteFilePath());
+        QVERIFY(file.open(QIODevice::WriteOnly));
+    };
+    touch("mod.py");
+    touch("ext.cpython-35m-x86_64-linux-gnu.so");
+    touch("pkg/__init__.py");
+    touch("pkg/sub.py");
+    touch("pkg/inner/__init__.py");
+    touch("bad-name/x.py");
+
+    auto index = Python::ModuleIndex::self();
+    const QList<QUrl> searchPaths{QUrl::fromLocalFile(root)};
+    index->index(searchPaths);
+    Python::ModuleIndex::Directory contents;
+    QTRY_VERIFY(index->contents(root + "/pkg/inner", &contents));
+    QVERIFY(index->contents(root, &contents));
+    QCOMPARE(contents.files, QSet<QString>({"mod.py", "ext.cpython-35m-x86_64-linux-gnu.so"}));
+    QCOMPARE(contents.directories, QSet<QString>({"pkg"}));
+
+    QPair<QUrl, QStringList> found;
+    QVERIFY(index->findModulePath("pkg.sub.func", searchPaths, &found));
+    QCOMPARE(found.first, QUrl::fromLocalFile(root + "/pkg/sub.py"));
+    QCOMPARE(found.second, QStringList{"func"});
+    QVERIFY(index->findModulePath("pkg.inner", searchPaths, &found));
+    QCOMPARE(found.first, QUrl::fromLocalFile(root + "/pkg/inner/__init__.py"));
+    QVERIFY(found.second.isEmpty());
+    QVERIFY(index->findModulePath("mod.a.b", searchPaths, &found));
+    QCOMPARE(found.first, QUrl::fromLocalFile(root + "/mod.py"));
+    QCOMPARE(found.second, QStringList({"a", "b"}));
+    QVERIFY(index->findModulePath("missing", searchPaths, &found));
+    QVERIFY(! found.first.isValid());
+    // relative imports are not handled by the index
+    QVERIFY(! index->findModulePath(".mod", searchPaths, &found));
+
+    // changes on the disk are picked up
+    touch("pkg/added.py");
+    QTRY_VERIFY(index->contents(root + "/pkg", &contents) && contents.files.contains("added.py"));
+
+    // a changed directory is read again on its own; the trees below it stay indexed meanwhile
+    touch("saved.py");
+    QVERIFY(index->contents(root + "/pkg/inner", &contents));
+    QTRY_VERIFY(index->contents(root, &contents) && contents.files.contains("saved.py"));
+    QVERIFY(index->contents(root + "/pkg/inner", &contents));
+
+    // new sub-directories are indexed, removed ones are dropped
+    touch("newpkg/deep/__init__.py");
+    QTRY_VERIFY(index->contents(root + "/newpkg/deep", &contents) && contents.files.contains("__init__.py"));
+    QVERIFY(QDir(root + "/pkg").removeRecursively());
+    QTRY_VERIFY(! index->contents(root + "/pkg/inner", &contents));
+    QVERIFY(index->contents(root, &contents));
+    QCOMPARE(contents.directories, QSet<QString>({"newpkg"}));
+}
+
+void PyDUChainTest::testAbortedParseRebuiltFully() {
+    // a new document which takes long enough to build that the job can be aborted while its builders run
+    QString code;
+    for ( int i = 0; i < 50000; i++ ) {
+        code += QString("name%1 = %1\n").arg(i);
+    }
+    code += "last_name = 0\n";
+    const QString path = testDir.absolutePath() + "/abortedparse.py";
+    QFile file(path);
+    QVERIFY(file.open(QIODevice::WriteOnly));
+    file.write(code.toUtf8());
+    file.close();
+    const IndexedString url(QUrl::fromLocalFile(path));
+    auto parser = ICore::self()->languageController()->backgroundParser();
+    const auto registered = [&url]() {
+        DUChainReadLocker lock;
+        return DUChain::self()->chainForDocument(url) != nullptr;
+    };
+
+    DUChain::self()->updateContextForUrl(url, TopDUContext::AllDeclarationsContextsAndUses);
+    parser->parseDocuments();
+    // the context is registered in the DUChain before the declarations are built
+    QTRY_VERIFY_WITH_TIMEOUT(registered(), 60000);
+    KDevelop::ParseJob* job = parser->parseJobForDocument(url);
+    QVERIFY(job);
+    job->requestAbort();
+    QTRY_VERIFY_WITH_TIMEOUT(! parser->parseJobForDocument(url), 60000);
+    {
+        DUChainReadLocker lock;
+        TopDUContext* top = DUChain::self()->chainForDocument(url);
+        QVERIFY(top);
+        QVERIFY(top->findDeclarations(QualifiedIdentifier("last_name")).isEmpty());
+        // the incomplete context must not be taken as up to date
+        QVERIFY(top->parsingEnvironmentFile()->needsUpdate());
+    }
+
+    // the next parse, without forcing it, completes the context
+    DUChain::self()->updateContextForUrl(url, TopDUContext::AllDeclarationsContextsAndUses);
+    parser->parseDocuments();
+    ReferencedTopDUContext top = DUChain::self()->waitForUpdate(url, TopDUContext::AllDeclarationsContextsAndUses);
+    QVERIFY(top);
+    DUChainReadLocker lock;
+    QCOMPARE(top->findDeclarations(QualifiedIdentifier("name0")).size(), 1);
+    QCOMPARE(top->findDeclarations(QualifiedIdentifier("last_name")).size(), 1);
+    QVERIFY(! top->parsingEnvironmentFile()->needsUpdate());
+}
+
 void PyDUChainTest::testCrashes() {
     QFETCH(QString, code);
     ReferencedTopDUContext ctx = parse(code);
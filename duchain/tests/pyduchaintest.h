@@ -62,6 +62,12 @@ class PyDUChainTest : public QObject
         void testImportDeclarations();
         void testImportDeclarations_data();
         void testImportFiles();
+        void testImportFilesOnlyAccessed();
+        void testImportGraphScan();
+        void testImportGraphScan_data();
+        void testImportGraphLevels();
+        void testModuleIndex();
+        void testAbortedParseRebuiltFully();
         void testCrashes();
         void testCrashes_data();
         void testFlickering();
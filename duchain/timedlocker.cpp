@@ -0,0 +1,87 @@
+/*****************************************************************************
+ * This file is part of KDevelop                                             *
+ * Copyright 2026 agent <agent@local>                                        *
+ *                                                                           *
+ * This program is free software; you can redistribute it and/or             *
+ * modify it under the terms of the GNU General Public License as            *
+ * published by the Free Software Foundation; either version 2 of            *
+ * the License, or (at your option) any later version.                       *
+ *                                                                           *
+ * This program is distributed in the hope that it will be useful,           *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the             *
+ * GNU General Public License for more details.                              *
+ *                                                                           *
+ * You should have received a copy of the GNU General Public License         *
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.     *
+ *****************************************************************************
+ */
+
+#include "timedlocker.h"
+
+#include "lockstatistics.h"
+
+using namespace KDevelop;
+
+namespace Python
+{
+
+TimedDUChainLocker::TimedDUChainLocker(Mode mode, const char* name, DUChainLock* duChainLock)
+    : m_mode(mode)
+    , m_name(name)
+    , m_duChainLock(duChainLock)
+{
+    lock();
+}
+
+TimedDUChainLocker::~TimedDUChainLocker()
+{
+    unlock();
+}
+
+bool TimedDUChainLocker::lock()
+{
+    if ( m_locked ) {
+        return true;
+    }
+    if ( LockStatistics::isEnabled() ) {
+        // nested acquisitions don't wait, and don't end the hold time when released
+        m_timed = m_mode == Write ? ! m_duChainLock->currentThreadHasWriteLock()
+                                  : ! m_duChainLock->currentThreadHasReadLock() && ! m_duChainLock->currentThreadHasWriteLock();
+        if ( m_timed ) {
+            m_timer.start();
+        }
+    }
+    m_locked = m_mode == Write ? m_duChainLock->lockForWrite() : m_duChainLock->lockForRead();
+    if ( m_timed ) {
+        m_waitNsecs = m_timer.nsecsElapsed();
+        m_timer.restart();
+    }
+    return m_locked;
+}
+
+void TimedDUChainLocker::unlock()
+{
+    if ( ! m_locked ) {
+        return;
+    }
+    const qint64 holdNsecs = m_timed ? m_timer.nsecsElapsed() : 0;
+    if ( m_mode == Write ) {
+        m_duChainLock->releaseWriteLock();
+    }
+    else {
+        m_duChainLock->releaseReadLock();
+    }
+    m_locked = false;
+    if ( m_timed ) {
+        LockStatistics::record(m_name, m_waitNsecs, holdNsecs);
+        m_timed = false;
+    }
+}
+
+bool TimedDUChainLocker::locked() const
+{
+    return m_locked;
+}
+
+}
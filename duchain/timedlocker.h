@@ -0,0 +1,82 @@
+/*****************************************************************************
+ * This file is part of KDevelop                                             *
+ * Copyright 2026 agent <agent@local>                                        *
+ *                                                                           *
+ * This program is free software; you can redistribute it and/or             *
+ * modify it under the terms of the GNU General Public License as            *
+ * published by the Free Software Foundation; either version 2 of            *
+ * the License, or (at your option) any later version.                       *
+ *                                                                           *
+ * This program is distributed in the hope that it will be useful,           *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the             *
+ * GNU General Public License for more details.                              *
+ *                                                                           *
+ * You should have received a copy of the GNU General Public License         *
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.     *
+ *****************************************************************************
+ */
+
+#ifndef PYTHON_TIMEDLOCKER_H
+#define PYTHON_TIMEDLOCKER_H
+
+#include <QElapsedTimer>
+
+#include <language/duchain/duchain.h>
+#include <language/duchain/duchainlock.h>
+
+#include "pythonduchainexport.h"
+
+namespace Python
+{
+
+/**
+ * @brief Like KDevelop::DUChainReadLocker and DUChainWriteLocker, but records wait and hold times in LockStatistics.
+ *
+ * Every lock() / unlock() cycle is one acquisition of the lock called @p name. Acquisitions while the
+ * calling thread already holds the lock are not recorded, they neither wait nor extend the hold time.
+ * If statistics are disabled, this does nothing but lock and unlock.
+ */
+class KDEVPYTHONDUCHAIN_EXPORT TimedDUChainLocker
+{
+public:
+    ~TimedDUChainLocker();
+    bool lock();
+    void unlock();
+    bool locked() const;
+
+protected:
+    enum Mode {
+        Read,
+        Write
+    };
+    TimedDUChainLocker(Mode mode, const char* name, KDevelop::DUChainLock* duChainLock);
+
+private:
+    Q_DISABLE_COPY(TimedDUChainLocker)
+    const Mode m_mode;
+    const char* m_name;
+    KDevelop::DUChainLock* m_duChainLock;
+    bool m_locked = false;
+    bool m_timed = false;
+    QElapsedTimer m_timer;
+    qint64 m_waitNsecs = 0;
+};
+
+class KDEVPYTHONDUCHAIN_EXPORT TimedDUChainReadLocker : public TimedDUChainLocker
+{
+public:
+    explicit TimedDUChainReadLocker(const char* name, KDevelop::DUChainLock* duChainLock = KDevelop::DUChain::lock())
+        : TimedDUChainLocker(Read, name, duChainLock) { }
+};
+
+class KDEVPYTHONDUCHAIN_EXPORT TimedDUChainWriteLocker : public TimedDUChainLocker
+{
+public:
+    explicit TimedDUChainWriteLocker(const char* name, KDevelop::DUChainLock* duChainLock = KDevelop::DUChain::lock())
+        : TimedDUChainLocker(Write, name, duChainLock) { }
+};
+
+}
+
+#endif // PYTHON_TIMEDLOCKER_H
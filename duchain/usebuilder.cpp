@@ -33,6 +33,7 @@
 #include "ast.h"
 #include "expressionvisitor.h"
 #include "helpers.h"
+#include "timedlocker.h"
 
 using namespace KTextEditor;
 using namespace KDevelop;
@@ -51,7 +52,7 @@ DUContext* UseBuilder::contextAtOrCurrent(const CursorInRevision& pos)
 {
     DUContext* context = 0;
     {
-        DUChainReadLocker lock;
+        TimedDUChainReadLocker lock("DUChain read lock (UseBuilder)");
         context = topContext()->findContextAt(pos, true);
     }
     if ( ! context ) {
@@ -84,17 +85,13 @@ void UseBuilder::visitName(NameAst* node)
             p->setSource(KDevelop::IProblem::SemanticAnalysis);
             p->setSeverity(KDevelop::IProblem::Hint);
             p->setDescription(i18n("Undefined variable: %1", node->identifier->value));
-            {
-                DUChainWriteLocker wlock(DUChain::lock());
-                ProblemPointer ptr(p);
-                topContext()->addProblem(ptr);
-            }
+            reportProblem(ProblemPointer(p));
         }
     }
     
     if ( declaration && declaration->abstractType() && declaration->abstractType()->whichType() == AbstractType::TypeStructure ) {
         if ( node->belongsToCall ) {
-            DUChainReadLocker lock;
+            TimedDUChainReadLocker lock("DUChain read lock (UseBuilder)");
             QPair< Python::FunctionDeclarationPointer, bool > constructor = Helper::
                              functionDeclarationForCalledDeclaration(DeclarationPointer(declaration));
             lock.unlock();
@@ -125,7 +122,7 @@ void UseBuilder::visitAttribute(AttributeAst* node)
                              node->attribute->endLine, node->attribute->endCol + 1);
     
     DeclarationPointer declaration = v.lastDeclaration();
-    DUChainWriteLocker wlock;
+    TimedDUChainReadLocker lock("DUChain read lock (UseBuilder)");
     if ( declaration && declaration->range() == useRange ) {
         // this is the declaration, don't build a use for it
         return;
@@ -136,9 +133,9 @@ void UseBuilder::visitAttribute(AttributeAst* node)
         p->setSource(KDevelop::IProblem::SemanticAnalysis);
         p->setSeverity(KDevelop::IProblem::Hint);
         p->setDescription(i18n("Attribute \"%1\" not found on accessed object", node->attribute->value));
-        ProblemPointer ptr(p);
-        topContext()->addProblem(ptr);
+        reportProblem(ProblemPointer(p));
     }
+    lock.unlock();
     UseBuilderBase::newUse(node, useRange, declaration);
 }
 
@@ -34,6 +34,7 @@
 #include "python_header.h"
 #include "astdefaultvisitor.h"
 #include "cythonsyntaxremover.h"
+#include "lockstatistics.h"
 
 #include <interfaces/icore.h>
 #include <interfaces/iprojectcontroller.h>
@@ -449,10 +450,11 @@ QPair<QString, int> fileHeaderHack(QString& contents, const QUrl& filename)
 }
 
 namespace {
-struct PythonInitializer : private QMutexLocker {
+struct PythonInitializer {
     PythonInitializer(QMutex& pyInitLock):
-        QMutexLocker(&pyInitLock), arena(0)
+        timer("AstBuilder::pyInitLock"), locker(&pyInitLock), arena(0)
     {
+            timer.acquired();
             Py_InitializeEx(0);
             Q_ASSERT(Py_IsInitialized());
 
@@ -466,6 +468,9 @@ struct PythonInitializer : private QMutexLocker {
         if (Py_IsInitialized())
             Py_Finalize();
     }
+    // declared before the locker, so the unlock is included in the measured hold time
+    LockTimer timer;
+    QMutexLocker locker;
     PyArena* arena;
 };
 }
@@ -18,6 +18,7 @@
 
 
 #include "codehelpers.h"
+#include "reversetokenizer.h"
 #include <QStack>
 
 namespace Python {
@@ -178,96 +179,55 @@ QString CodeHelpers::expressionUnderCursor(Python::LazyLineFetcher& lineFetcher,
     startCursor = cursor;
     QString line = lineFetcher.fetchLine(cursor.line());
     int index = cursor.column();
-    QChar c = line[index];
+    QChar c = index < line.size() ? line.at(index) : QChar();
     
     int end = index;
     // This flag is used by codecompletion (in contrast to the debugger)
     if ( ! forceScanExpression ) {
-        if ( ! c.isLetterOrNumber() && c != '_' ) {
+        if ( ! ReverseTokenizer::is(c, ReverseTokenizer::IdentifierChar) ) {
             return QString();
         }
     }
     for (; end < line.size(); ++end)
     {
-        QChar c = line[end];
-        if ( ! ( c.isLetterOrNumber() || c == '_' ) ) {
+        if ( ! ReverseTokenizer::is(line.at(end), ReverseTokenizer::IdentifierChar) ) {
             if ( ! forceScanExpression ) end--;
             break;
         }
     }
-    int start = index;
-    QStringList openingBrackets = QStringList() << "(" << "[" << "{" << "\"" << "'";
-    QStringList closingBrackets = QStringList() << ")" << "]" << "}" << "\"" << "'";
-    QStringList sliceChars = QStringList() << "." << "(" << "["; // chars which are allowed to be preceded by a space
-    QStringList seperatorChars = QStringList() << "," << "=" << ":" << "*" << "-" << "+" << "/" << "%" << "^" << "~";
-    QStack<QString> brackets;
-    bool lastWasSlice = false;
-    int linesFetched = 1;
+
+    ReverseTokenizer::ExpressionScan scan;
+    int lineNumber = cursor.line();
+    int lastColumn = end;
     QString text;
-    bool done = false;
-    while ( start != 0 ) {
-        while ( start >= 0 ) {
-            QChar c = line[start];
-            int bracket = closingBrackets.indexOf(c);
-            if ( ! brackets.isEmpty() && brackets.top() == c ) {
-                brackets.pop();
-            }
-            else if ( bracket != -1 ) {
-                brackets.push(openingBrackets.at(bracket));
-            }
-            else if ( openingBrackets.contains(c) ) {
-                start += 1;
-                done = true;
-                break;
-            }
-            
-            if ( brackets.isEmpty() && ( (c.isSpace() && ! lastWasSlice) || seperatorChars.contains(c) ) ) {
-                done = true;
-                start += 1;
-                break;
-            }
-            
-            if ( sliceChars.contains(c) ) {
-                lastWasSlice = true;
-            }
-            else {
-                lastWasSlice = false;
-            }
-            start--;
-        }
-        if ( done ) {
+    int start = ReverseTokenizer::expressionStart(line, qMin(index, line.size() - 1), scan);
+    while ( start == -1 ) {
+        start = 0;
+        if ( lineNumber == 0 ) {
             break;
         }
-        if ( cursor.line() < linesFetched ) {
-            break;
-        }
-        if ( brackets.isEmpty() && ! lineFetcher.fetchLine(cursor.line() - linesFetched).trimmed().endsWith('\\') ) {
+        QString previousLine = lineFetcher.fetchLine(lineNumber - 1);
+        if ( scan.brackets.isEmpty() && ! previousLine.trimmed().endsWith('\\') ) {
             // break at newline without previous backslash
             break;
         }
-        // store this line for multi-line expressions
-        if ( linesFetched != 1 ) {
-            text.prepend(line);
-        }
-        else {
-            text.prepend(line.mid(0, end));
+        int previousNumber = lineNumber - 1;
+        while ( previousLine.isEmpty() && previousNumber > 0 ) {
+            previousLine = lineFetcher.fetchLine(--previousNumber);
         }
-        line.clear();
-        while ( line.isEmpty() && cursor.line() >= linesFetched ) {
-            line = lineFetcher.fetchLine(cursor.line() - linesFetched);
-            linesFetched++;
-            start = line.length() - 1;
+        if ( previousLine.isEmpty() ) {
+            break;
         }
+        // store this line for multi-line expressions
+        text.prepend(line.mid(0, lastColumn + 1));
+        line = previousLine;
+        lineNumber = previousNumber;
+        lastColumn = line.size() - 1;
+        start = ReverseTokenizer::expressionStart(line, lastColumn, scan);
     }
-    start = qMax(0, start);
-    QString linePart;
-    if ( start > end ) {
-        linePart = QString();
-    }
-    else {
-        linePart = line.mid(start, end-start + 1);
-        startCursor.setColumn(start);
-    }
+
+    const QString linePart = line.mid(start, lastColumn - start + 1);
+    startCursor = KTextEditor::Cursor(lineNumber, start);
 
     QString expression(linePart + text);
     expression = expression.trimmed();
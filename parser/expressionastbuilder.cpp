@@ -0,0 +1,568 @@
+/*
+    This file is part of kdev-python, the python language plugin for KDevelop
+    Copyright (C) 2026 agent <agent@local>
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "expressionastbuilder.h"
+
+#include <QSet>
+
+namespace Python {
+
+namespace {
+
+bool isKeyword(const QString& name)
+{
+    static const QSet<QString> keywords{
+        "False", "None", "True", "and", "as", "assert", "async", "await", "break", "class", "continue",
+        "def", "del", "elif", "else", "except", "finally", "for", "from", "global", "if", "import",
+        "in", "is", "lambda", "nonlocal", "not", "or", "pass", "raise", "return", "try", "while",
+        "with", "yield"
+    };
+    return keywords.contains(name);
+}
+
+bool isStringPrefix(const QString& name)
+{
+    static const QSet<QString> prefixes{"r", "u", "b", "br", "rb"};
+    return prefixes.contains(name.toLower());
+}
+
+// Frees a subtree which could not be completed.
+void discard(Ast* node)
+{
+    if ( node ) {
+        CodeAst owner;
+        owner.body.append(node);
+    }
+}
+
+class Parser
+{
+public:
+    explicit Parser(const QString& text)
+        : m_text(text)
+    {
+    }
+
+    ExpressionAst* parseTopLevel(Ast* parent)
+    {
+        skipWhitespace();
+        ExpressionAst* result = parseExpression(parent);
+        skipWhitespace();
+        if ( result && ! atEnd() ) {
+            discard(result);
+            return nullptr;
+        }
+        return result;
+    }
+
+private:
+    QChar peek(int offset = 0) const
+    {
+        const int pos = m_pos + offset;
+        return pos < m_text.size() ? m_text.at(pos) : QChar();
+    }
+
+    bool atEnd() const
+    {
+        return m_pos >= m_text.size();
+    }
+
+    void advance()
+    {
+        if ( m_text.at(m_pos) == '\n' ) {
+            m_line++;
+            m_col = 0;
+        }
+        else {
+            m_col++;
+        }
+        m_pos++;
+    }
+
+    void skipWhitespace()
+    {
+        while ( ! atEnd() && peek().isSpace() ) {
+            advance();
+        }
+    }
+
+    // Skip whitespace, then consume @p c if it is the next character.
+    bool accept(QChar c)
+    {
+        skipWhitespace();
+        if ( peek() == c ) {
+            advance();
+            return true;
+        }
+        return false;
+    }
+
+    template<typename T>
+    T* start(Ast* parent)
+    {
+        T* node = new T(parent);
+        node->startLine = m_line;
+        node->startCol = m_col;
+        node->hasUsefulRangeInformation = true;
+        return node;
+    }
+
+    // Set the end of @p node to the character before the current position.
+    template<typename T>
+    T* finish(T* node)
+    {
+        node->endLine = m_line;
+        node->endCol = m_col - 1;
+        return node;
+    }
+
+    QString readName()
+    {
+        const int begin = m_pos;
+        if ( peek().isLetter() || peek() == '_' ) {
+            while ( ! atEnd() && ( peek().isLetterOrNumber() || peek() == '_' ) ) {
+                advance();
+            }
+        }
+        return m_text.mid(begin, m_pos - begin);
+    }
+
+    Identifier* parseIdentifier(Ast* parent)
+    {
+        skipWhitespace();
+        auto identifier = new Identifier(QString());
+        identifier->parent = parent;
+        identifier->startLine = m_line;
+        identifier->startCol = m_col;
+        identifier->value = readName();
+        identifier->endLine = m_line;
+        identifier->endCol = m_col - 1;
+        identifier->hasUsefulRangeInformation = true;
+        if ( identifier->value.isEmpty() || isKeyword(identifier->value) ) {
+            delete identifier;
+            return nullptr;
+        }
+        return identifier;
+    }
+
+    ExpressionAst* parseExpression(Ast* parent)
+    {
+        skipWhitespace();
+        ExpressionAst* result = parseAtom(parent);
+        while ( result ) {
+            skipWhitespace();
+            const QChar c = peek();
+            if ( c == '.' ) {
+                advance();
+                auto attribute = start<AttributeAst>(parent);
+                attribute->copyRange(result);
+                attribute->hasUsefulRangeInformation = true;
+                attribute->context = ExpressionAst::Load;
+                attribute->value = result;
+                result->parent = attribute;
+                attribute->attribute = parseIdentifier(attribute);
+                result = attribute;
+                if ( ! attribute->attribute ) {
+                    break;
+                }
+                finish(attribute);
+            }
+            else if ( c == '(' ) {
+                auto call = start<CallAst>(parent);
+                call->copyRange(result);
+                call->function = result;
+                result->parent = call;
+                result->belongsToCall = call;
+                result = call;
+                advance();
+                if ( ! parseArguments(call) ) {
+                    break;
+                }
+                finish(call);
+            }
+            else if ( c == '[' ) {
+                auto subscript = start<SubscriptAst>(parent);
+                subscript->copyRange(result);
+                subscript->context = ExpressionAst::Load;
+                subscript->value = result;
+                result->parent = subscript;
+                result = subscript;
+                advance();
+                auto index = start<IndexAst>(subscript);
+                subscript->slice = index;
+                index->value = parseExpression(index);
+                // slices and multiple indices are not supported
+                if ( ! index->value || ! accept(']') ) {
+                    break;
+                }
+                finish(index);
+                finish(subscript);
+            }
+            else {
+                return result;
+            }
+        }
+        discard(result);
+        return nullptr;
+    }
+
+    bool parseArguments(CallAst* call)
+    {
+        if ( accept(')') ) {
+            return true;
+        }
+        forever {
+            skipWhitespace();
+            // keyword argument?
+            const int pos = m_pos, line = m_line, col = m_col;
+            const QString name = readName();
+            skipWhitespace();
+            if ( ! name.isEmpty() && ! isKeyword(name) && peek() == '=' && peek(1) != '=' ) {
+                m_pos = pos; m_line = line; m_col = col;
+                auto keyword = new KeywordAst(call);
+                keyword->argumentName = parseIdentifier(keyword);
+                call->keywords.append(keyword);
+                accept('=');
+                keyword->value = parseExpression(keyword);
+                if ( ! keyword->value ) {
+                    return false;
+                }
+            }
+            else {
+                m_pos = pos; m_line = line; m_col = col;
+                // *args and **kwargs are not supported
+                auto argument = parseExpression(call);
+                if ( ! argument ) {
+                    return false;
+                }
+                call->arguments.append(argument);
+            }
+            if ( accept(')') ) {
+                return true;
+            }
+            if ( ! accept(',') ) {
+                return false;
+            }
+            if ( accept(')') ) {
+                return true;
+            }
+        }
+    }
+
+    // Parse comma-separated expressions until @p close. Sets @p sawComma if there was at least one comma.
+    bool parseElements(QList<ExpressionAst*>& elements, Ast* parent, QChar close, bool* sawComma = nullptr)
+    {
+        if ( accept(close) ) {
+            return true;
+        }
+        forever {
+            auto element = parseExpression(parent);
+            if ( ! element ) {
+                return false;
+            }
+            elements.append(element);
+            if ( accept(close) ) {
+                return true;
+            }
+            if ( ! accept(',') ) {
+                return false;
+            }
+            if ( sawComma ) {
+                *sawComma = true;
+            }
+            if ( accept(close) ) {
+                return true;
+            }
+        }
+    }
+
+    ExpressionAst* parseAtom(Ast* parent)
+    {
+        const QChar c = peek();
+        if ( c.isLetter() || c == '_' ) {
+            const int pos = m_pos, line = m_line, col = m_col;
+            const QString name = readName();
+            if ( ( peek() == '\'' || peek() == '"' ) && isStringPrefix(name) ) {
+                m_pos = pos; m_line = line; m_col = col;
+                return parseString(parent);
+            }
+            if ( name == QLatin1String("None") || name == QLatin1String("True") || name == QLatin1String("False") ) {
+                m_pos = pos; m_line = line; m_col = col;
+                auto constant = start<NameConstantAst>(parent);
+                readName();
+                constant->value = name == QLatin1String("None") ? NameConstantAst::None
+                                : name == QLatin1String("True") ? NameConstantAst::True : NameConstantAst::False;
+                return finish(constant);
+            }
+            m_pos = pos; m_line = line; m_col = col;
+            auto nameAst = start<NameAst>(parent);
+            nameAst->context = ExpressionAst::Load;
+            nameAst->identifier = parseIdentifier(nameAst);
+            if ( ! nameAst->identifier ) {
+                discard(nameAst);
+                return nullptr;
+            }
+            return finish(nameAst);
+        }
+        if ( c.isDigit() || ( c == '.' && peek(1).isDigit() ) ) {
+            return parseNumber(parent);
+        }
+        if ( c == '\'' || c == '"' ) {
+            return parseString(parent);
+        }
+        if ( c == '(' ) {
+            auto tuple = start<TupleAst>(parent);
+            tuple->context = ExpressionAst::Load;
+            advance();
+            bool sawComma = false;
+            if ( ! parseElements(tuple->elements, tuple, ')', &sawComma) ) {
+                discard(tuple);
+                return nullptr;
+            }
+            finish(tuple);
+            if ( tuple->elements.size() == 1 && ! sawComma ) {
+                // just parentheses around an expression
+                auto inner = tuple->elements.takeFirst();
+                inner->parent = parent;
+                discard(tuple);
+                return inner;
+            }
+            return tuple;
+        }
+        if ( c == '[' ) {
+            auto list = start<ListAst>(parent);
+            list->context = ExpressionAst::Load;
+            advance();
+            if ( ! parseElements(list->elements, list, ']') ) {
+                discard(list);
+                return nullptr;
+            }
+            return finish(list);
+        }
+        if ( c == '{' ) {
+            return parseDictOrSet(parent);
+        }
+        return nullptr;
+    }
+
+    ExpressionAst* parseDictOrSet(Ast* parent)
+    {
+        const int pos = m_pos, line = m_line, col = m_col;
+        advance();
+        if ( accept('}') ) {
+            m_pos = pos; m_line = line; m_col = col;
+            auto dict = start<DictAst>(parent);
+            advance();
+            accept('}');
+            return finish(dict);
+        }
+        // find out whether this is a dict or a set from the first element
+        auto first = parseExpression(nullptr);
+        const bool isDict = first && accept(':');
+        discard(first);
+        m_pos = pos; m_line = line; m_col = col;
+
+        if ( ! isDict ) {
+            auto set = start<SetAst>(parent);
+            advance();
+            if ( ! parseElements(set->elements, set, '}') ) {
+                discard(set);
+                return nullptr;
+            }
+            return finish(set);
+        }
+        auto dict = start<DictAst>(parent);
+        advance();
+        forever {
+            auto key = parseExpression(dict);
+            if ( ! key ) {
+                break;
+            }
+            dict->keys.append(key);
+            if ( ! accept(':') ) {
+                break;
+            }
+            auto value = parseExpression(dict);
+            if ( ! value ) {
+                break;
+            }
+            dict->values.append(value);
+            if ( accept('}') ) {
+                return finish(dict);
+            }
+            if ( ! accept(',') ) {
+                break;
+            }
+            if ( accept('}') ) {
+                return finish(dict);
+            }
+        }
+        discard(dict);
+        return nullptr;
+    }
+
+    ExpressionAst* parseNumber(Ast* parent)
+    {
+        auto number = start<NumberAst>(parent);
+        const int begin = m_pos;
+        bool isInt = true;
+        int base = 10;
+        if ( peek() == '0' && QStringLiteral("xXoObB").contains(peek(1)) ) {
+            base = peek(1).toLower() == 'x' ? 16 : peek(1).toLower() == 'o' ? 8 : 2;
+            advance();
+            advance();
+            while ( ! atEnd() && peek().isLetterOrNumber() ) {
+                advance();
+            }
+        }
+        else {
+            while ( ! atEnd() ) {
+                const QChar c = peek();
+                if ( c.isDigit() ) {
+                    advance();
+                }
+                else if ( c == '.' || c == 'j' || c == 'J' ) {
+                    isInt = false;
+                    advance();
+                }
+                else if ( ( c == 'e' || c == 'E' ) ) {
+                    isInt = false;
+                    advance();
+                    if ( peek() == '+' || peek() == '-' ) {
+                        advance();
+                    }
+                }
+                else {
+                    break;
+                }
+            }
+        }
+        // something like "3foo"
+        if ( peek().isLetter() || peek() == '_' ) {
+            discard(number);
+            return nullptr;
+        }
+        number->isInt = isInt;
+        if ( isInt ) {
+            const QString text = m_text.mid(begin, m_pos - begin);
+            bool ok = false;
+            number->value = ( base == 10 ? text : text.mid(2) ).toLong(&ok, base);
+            if ( ! ok ) {
+                discard(number);
+                return nullptr;
+            }
+        }
+        return finish(number);
+    }
+
+    ExpressionAst* parseString(Ast* parent)
+    {
+        const int line = m_line, col = m_col;
+        QString value;
+        bool isBytes = false;
+        // adjacent literals are concatenated
+        do {
+            const QString prefix = readName().toLower();
+            isBytes = prefix.contains('b');
+            const bool raw = prefix.contains('r');
+            const QChar quote = peek();
+            const bool triple = peek(1) == quote && peek(2) == quote;
+            const int quoteLength = triple ? 3 : 1;
+            for ( int i = 0; i < quoteLength; i++ ) {
+                advance();
+            }
+            forever {
+                if ( atEnd() || ( ! triple && peek() == '\n' ) ) {
+                    return nullptr;
+                }
+                const QChar c = peek();
+                if ( c == quote && ( ! triple || ( peek(1) == quote && peek(2) == quote ) ) ) {
+                    for ( int i = 0; i < quoteLength; i++ ) {
+                        advance();
+                    }
+                    break;
+                }
+                advance();
+                if ( c == '\\' && ! atEnd() ) {
+                    const QChar escaped = peek();
+                    advance();
+                    if ( raw ) {
+                        value.append(c).append(escaped);
+                    }
+                    else if ( escaped == 'n' ) {
+                        value.append('\n');
+                    }
+                    else if ( escaped == 't' ) {
+                        value.append('\t');
+                    }
+                    else if ( escaped == '\\' || escaped == '\'' || escaped == '"' ) {
+                        value.append(escaped);
+                    }
+                    else if ( escaped != '\n' ) {
+                        value.append(c).append(escaped);
+                    }
+                    continue;
+                }
+                value.append(c);
+            }
+            skipWhitespace();
+        } while ( peek() == '\'' || peek() == '"'
+                  || ( ( peek().isLetter() ) && isStringPrefix(QString(peek())) && ( peek(1) == '\'' || peek(1) == '"' ) ) );
+
+        ExpressionAst* result = nullptr;
+        if ( isBytes ) {
+            auto bytes = new BytesAst(parent);
+            bytes->value = value;
+            result = bytes;
+        }
+        else {
+            auto string = new StringAst(parent);
+            string->value = value;
+            string->usedAsComment = false;
+            result = string;
+        }
+        result->startLine = line;
+        result->startCol = col;
+        result->hasUsefulRangeInformation = true;
+        return finish(result);
+    }
+
+    const QString& m_text;
+    int m_pos = 0;
+    int m_line = 0;
+    int m_col = 0;
+};
+
+}
+
+CodeAst::Ptr ExpressionAstBuilder::parse(const QString& expression)
+{
+    CodeAst::Ptr ast(new CodeAst);
+    auto statement = new ExpressionAst(ast.data());
+    ast->body.append(statement);
+    Parser parser(expression);
+    statement->value = parser.parseTopLevel(statement);
+    if ( ! statement->value ) {
+        return CodeAst::Ptr();
+    }
+    statement->copyRange(statement->value);
+    statement->hasUsefulRangeInformation = true;
+    return ast;
+}
+
+}
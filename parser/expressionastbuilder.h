@@ -0,0 +1,50 @@
+/*
+    This file is part of kdev-python, the python language plugin for KDevelop
+    Copyright (C) 2026 agent <agent@local>
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef PYTHON_EXPRESSIONASTBUILDER_H
+#define PYTHON_EXPRESSIONASTBUILDER_H
+
+#include <QString>
+
+#include "ast.h"
+#include "parserexport.h"
+
+namespace Python {
+
+/**
+ * @brief Builds the syntax tree for simple expressions, without using the python interpreter.
+ *
+ * Supported are names, attribute accesses, calls (with positional and keyword arguments),
+ * subscripts with a single index, and literals (numbers, strings, None/True/False, tuples, lists,
+ * dicts and sets). This covers what code completion usually needs to evaluate, and unlike
+ * AstBuilder it does not need to wait for the interpreter lock held by background parse jobs.
+ */
+class KDEVPYTHONPARSER_EXPORT ExpressionAstBuilder
+{
+public:
+    /**
+     * @brief Build the syntax tree for @p expression.
+     * @return a module which contains @p expression as its only statement, or a null pointer if
+     *         @p expression is not in the supported subset; use AstBuilder in that case.
+     */
+    static CodeAst::Ptr parse(const QString& expression);
+};
+
+}
+
+#endif // PYTHON_EXPRESSIONASTBUILDER_H
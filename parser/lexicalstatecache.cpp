@@ -0,0 +1,292 @@
+/*
+    This file is part of kdev-python, the python language plugin for KDevelop
+    Copyright (C) 2026 agent <agent@local>
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "lexicalstatecache.h"
+
+#include <QHash>
+#include <QMutex>
+#include <QMutexLocker>
+
+#include <algorithm>
+
+namespace Python {
+
+namespace {
+
+struct ScanState {
+    LexicalState::OpenString openString = LexicalState::NoString;
+    int bracketDepth = 0;
+    bool insideComment = false;
+    bool escapedNewline = false;
+};
+
+// in the order CodeHelpers::endsInside() checks them
+const struct {
+    const char* delimiter;
+    int length;
+    LexicalState::OpenString type;
+} delimiters[] = {
+    { "\"\"\"", 3, LexicalState::TripleDoubleQuote },
+    { "'''", 3, LexicalState::TripleSingleQuote },
+    { "'", 1, LexicalState::SingleQuote },
+    { "\"", 1, LexicalState::DoubleQuote }
+};
+
+// Scans text[from, to) like CodeHelpers::endsInside() does, and additionally counts brackets.
+void scan(const QString& text, int from, int to, ScanState& state)
+{
+    for ( int atChar = from; atChar < to; atChar++ ) {
+        const QChar c = text.at(atChar);
+        if ( c == ' ' || c.isLetterOrNumber() ) {
+            continue;
+        }
+        if ( state.openString == LexicalState::NoString && c == '#' ) {
+            state.insideComment = true;
+            continue;
+        }
+        if ( c == '\n' ) {
+            state.insideComment = false;
+            continue;
+        }
+        if ( state.insideComment ) {
+            continue;
+        }
+        if ( state.openString == LexicalState::NoString ) {
+            if ( c == '(' || c == '[' || c == '{' ) {
+                state.bracketDepth++;
+                continue;
+            }
+            if ( c == ')' || c == ']' || c == '}' ) {
+                state.bracketDepth = qMax(0, state.bracketDepth - 1);
+                continue;
+            }
+        }
+        if ( c != '"' && c != '\'' && c != '\\' ) {
+            continue;
+        }
+        QStringRef t;
+        if ( to - atChar > 2 ) {
+            t = text.midRef(atChar, 3);
+        }
+        for ( const auto& check : delimiters ) {
+            if ( t != QLatin1String(check.delimiter) && ! ( check.length == 1 && c == check.delimiter[0] ) ) {
+                continue;
+            }
+            if ( state.openString == LexicalState::NoString ) {
+                state.openString = check.type;
+                atChar += check.length - 1;
+                break;
+            }
+            else if ( state.openString == check.type ) {
+                state.openString = LexicalState::NoString;
+                atChar += check.length - 1;
+                break;
+            }
+        }
+        if ( c == '\\' ) {
+            if ( atChar + 1 < to && text.at(atChar + 1) == '\n' ) {
+                state.escapedNewline = true;
+            }
+            atChar ++;
+            continue;
+        }
+    }
+}
+
+int indentOf(const QString& text, int from, int to)
+{
+    for ( int i = from; i < to; i++ ) {
+        if ( ! text.at(i).isSpace() ) {
+            return i - from;
+        }
+    }
+    return to - from;
+}
+
+CodeHelpers::EndLocation location(const ScanState& state)
+{
+    if ( state.openString != LexicalState::NoString ) {
+        return CodeHelpers::String;
+    }
+    else if ( state.insideComment ) {
+        return CodeHelpers::Comment;
+    }
+    return CodeHelpers::Code;
+}
+
+struct CacheEntry {
+    LexicalState state;
+    quint64 lastUse = 0;
+};
+
+const int maxCachedDocuments = 16;
+QMutex cacheMutex;
+QHash<QString, CacheEntry> cache;
+quint64 useCounter = 0;
+
+}
+
+const QString& LexicalState::text() const
+{
+    return m_text;
+}
+
+int LexicalState::linesCount() const
+{
+    return m_lines.size();
+}
+
+const LexicalState::Line& LexicalState::line(int line) const
+{
+    return m_lines.at(line);
+}
+
+int LexicalState::indentForLine(int line) const
+{
+    return m_lines.at(line).indent;
+}
+
+CodeHelpers::EndLocation LexicalState::locationAt(int offset) const
+{
+    offset = qBound(0, offset, m_text.size());
+    auto it = std::upper_bound(m_lines.constBegin(), m_lines.constEnd(), offset, [](int offset, const Line& line) {
+        return offset < line.offset;
+    });
+    Q_ASSERT(it != m_lines.constBegin());
+    const Line& line = *(it - 1);
+    ScanState state;
+    state.openString = line.openString;
+    scan(m_text, line.offset, offset, state);
+    return location(state);
+}
+
+CodeHelpers::EndLocation LexicalState::endLocation() const
+{
+    return locationAt(m_text.size());
+}
+
+int LexicalState::offsetOfCursor(KTextEditor::Range range, KTextEditor::Cursor cursor) const
+{
+    int position = 0;
+    bool firstRow = true;
+    int startColumn = range.start().column();
+    int endColumn;
+    for ( int row = range.start().line(), i = 0; row <= cursor.line(); row++, i++ ) {
+        if ( row != cursor.line() ) {
+            if ( i >= m_lines.size() ) {
+                // something went wrong with the context ranges
+                break;
+            }
+            const int lineEnd = i + 1 < m_lines.size() ? m_lines.at(i + 1).offset - 1 : m_text.size();
+            endColumn = lineEnd - m_lines.at(i).offset;
+        }
+        else {
+            endColumn = cursor.column();
+        }
+        position += endColumn - startColumn + 1;
+        if ( firstRow ) {
+            startColumn = 0;
+            firstRow = false;
+        }
+    }
+    const int before = position - 1;
+    // QString::mid() returns everything for an out-of-range length
+    if ( before < 0 || before > m_text.size() ) {
+        return m_text.size();
+    }
+    return before;
+}
+
+int LexicalState::lastStatementOffset() const
+{
+    int line = m_lines.size() - 1;
+    while ( line > 0 ) {
+        const Line& current = m_lines.at(line);
+        if ( current.openString == NoString && current.bracketDepth == 0 && ! current.continued ) {
+            break;
+        }
+        line--;
+    }
+    return m_lines.at(line).offset;
+}
+
+LexicalState LexicalStateCache::state(const QString& document, const QString& text)
+{
+    QMutexLocker lock(&cacheMutex);
+    auto it = cache.find(document);
+    if ( it == cache.end() ) {
+        if ( cache.size() >= maxCachedDocuments ) {
+            auto oldest = std::min_element(cache.begin(), cache.end(), [](const CacheEntry& a, const CacheEntry& b) {
+                return a.lastUse < b.lastUse;
+            });
+            cache.erase(oldest);
+        }
+        it = cache.insert(document, CacheEntry());
+    }
+    CacheEntry& entry = *it;
+    entry.lastUse = ++useCounter;
+    const QString& previous = entry.state.m_text;
+    const int common = qMin(previous.size(), text.size());
+    const int commonPrefix = std::mismatch(previous.constData(), previous.constData() + common, text.constData()).first
+                             - previous.constData();
+    if ( commonPrefix != previous.size() || commonPrefix != text.size() ) {
+        update(entry.state, text, commonPrefix);
+    }
+    return entry.state;
+}
+
+LexicalState LexicalStateCache::compute(const QString& text)
+{
+    LexicalState state;
+    update(state, text, 0);
+    return state;
+}
+
+void LexicalStateCache::update(LexicalState& state, const QString& text, int commonPrefix)
+{
+    auto& lines = state.m_lines;
+    // A line is unchanged if the next one starts inside the common prefix, and the state at the beginning
+    // of a line only depends on the text before it; so scanning can resume at the first line which is not.
+    int resume = 0;
+    while ( resume + 1 < lines.size() && lines.at(resume + 1).offset <= commonPrefix ) {
+        resume++;
+    }
+    LexicalState::Line current = resume < lines.size() ? lines.at(resume) : LexicalState::Line();
+    lines.resize(resume);
+    state.m_text = text;
+
+    while ( true ) {
+        const int newline = text.indexOf('\n', current.offset);
+        const int contentEnd = newline == -1 ? text.size() : newline;
+        current.indent = indentOf(text, current.offset, contentEnd);
+        lines.append(current);
+        if ( newline == -1 ) {
+            break;
+        }
+        ScanState scanState;
+        scanState.openString = current.openString;
+        scanState.bracketDepth = current.bracketDepth;
+        scan(text, current.offset, newline + 1, scanState);
+        current.offset = newline + 1;
+        current.openString = scanState.openString;
+        current.bracketDepth = scanState.bracketDepth;
+        current.continued = scanState.escapedNewline;
+    }
+}
+
+}
@@ -0,0 +1,118 @@
+/*
+    This file is part of kdev-python, the python language plugin for KDevelop
+    Copyright (C) 2026 agent <agent@local>
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef PYTHON_LEXICALSTATECACHE_H
+#define PYTHON_LEXICALSTATECACHE_H
+
+#include <QString>
+#include <QVector>
+
+#include <KTextEditor/Range>
+
+#include "codehelpers.h"
+#include "parserexport.h"
+
+namespace Python {
+
+/**
+ * @brief Per-line lexical information about a piece of code: string and comment state, indentation and brackets.
+ *
+ * The string and comment state is determined exactly like CodeHelpers::endsInside() does it,
+ * and the indentation like FileIndentInformation does it.
+ */
+class KDEVPYTHONPARSER_EXPORT LexicalState
+{
+public:
+    enum OpenString {
+        NoString,
+        SingleQuote,
+        DoubleQuote,
+        TripleSingleQuote,
+        TripleDoubleQuote
+    };
+
+    struct Line {
+        int offset = 0;             // position of the first character of the line in the text
+        int indent = 0;
+        int bracketDepth = 0;       // open brackets at the beginning of the line
+        OpenString openString = NoString; // string which is still open at the beginning of the line
+        bool continued = false;     // the previous line ends with a backslash
+    };
+
+    const QString& text() const;
+    int linesCount() const;
+    const Line& line(int line) const;
+    int indentForLine(int line) const;
+
+    /**
+     * @brief Same as CodeHelpers::endsInside(text().left(offset)), but only scans the line containing @p offset.
+     */
+    CodeHelpers::EndLocation locationAt(int offset) const;
+
+    /**
+     * @brief Same as CodeHelpers::endsInside(text()).
+     */
+    CodeHelpers::EndLocation endLocation() const;
+
+    /**
+     * @brief Length of the code before @p cursor, split the same way as CodeHelpers::splitCodeByCursor() does it.
+     */
+    int offsetOfCursor(KTextEditor::Range range, KTextEditor::Cursor cursor) const;
+
+    /**
+     * @brief Offset of the first line of the statement the end of the text belongs to.
+     *
+     * This is the last line which does not start inside a string or brackets, and which does not continue
+     * the previous line with a backslash.
+     */
+    int lastStatementOffset() const;
+
+private:
+    friend class LexicalStateCache;
+    QString m_text;
+    QVector<Line> m_lines;
+};
+
+/**
+ * @brief Keeps the LexicalState of the text last seen for each document.
+ *
+ * Code completion requests the state for nearly the same text on every keystroke. Lines before the first
+ * changed character are taken from the cache, so only the lines after it are scanned again.
+ */
+class KDEVPYTHONPARSER_EXPORT LexicalStateCache
+{
+public:
+    /**
+     * @brief Get the lexical state of @p text, which is the current text of (a part of) @p document.
+     * Thread-safe.
+     */
+    static LexicalState state(const QString& document, const QString& text);
+
+    /**
+     * @brief Compute the state of @p text from scratch, without touching the cache.
+     */
+    static LexicalState compute(const QString& text);
+
+private:
+    // Keeps the lines of @p state up to @p commonPrefix, and rescans the rest for @p text.
+    static void update(LexicalState& state, const QString& text, int commonPrefix);
+};
+
+}
+
+#endif // PYTHON_LEXICALSTATECACHE_H
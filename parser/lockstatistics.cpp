@@ -0,0 +1,117 @@
+/*
+    This file is part of kdev-python, the python language plugin for KDevelop
+    Copyright (C) 2026 agent <agent@local>
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "lockstatistics.h"
+
+#include <QMutex>
+#include <QMutexLocker>
+#include <QStringList>
+
+#include <algorithm>
+
+namespace Python {
+
+namespace {
+QMutex statisticsMutex;
+QHash<QByteArray, LockStatistics::Entry> statistics;
+thread_local qint64 threadWaitTime = 0;
+}
+
+bool LockStatistics::isEnabled()
+{
+    // the parse profiler reports lock wait times, too
+    static const bool enabled = qEnvironmentVariableIsSet("KDEV_PYTHON_LOCK_STATISTICS")
+                                || qEnvironmentVariableIsSet("KDEV_PYTHON_PARSE_PROFILE");
+    return enabled;
+}
+
+void LockStatistics::record(const char* lock, qint64 waitNsecs, qint64 holdNsecs)
+{
+    if ( ! isEnabled() ) {
+        return;
+    }
+    threadWaitTime += waitNsecs;
+    QMutexLocker l(&statisticsMutex);
+    Entry& entry = statistics[QByteArray(lock)];
+    entry.acquisitions++;
+    entry.waitNsecs += waitNsecs;
+    entry.holdNsecs += holdNsecs;
+    entry.maxWaitNsecs = qMax(entry.maxWaitNsecs, waitNsecs);
+    entry.maxHoldNsecs = qMax(entry.maxHoldNsecs, holdNsecs);
+}
+
+QHash<QByteArray, LockStatistics::Entry> LockStatistics::snapshot()
+{
+    QMutexLocker l(&statisticsMutex);
+    return statistics;
+}
+
+void LockStatistics::reset()
+{
+    QMutexLocker l(&statisticsMutex);
+    statistics.clear();
+}
+
+QString LockStatistics::summary()
+{
+    const auto data = snapshot();
+    auto names = data.keys();
+    std::sort(names.begin(), names.end());
+    QStringList lines;
+    lines << QStringLiteral("lock | acquisitions | total wait ms | max wait ms | total hold ms | max hold ms");
+    foreach ( const QByteArray& name, names ) {
+        const Entry& e = data[name];
+        lines << QStringLiteral("%1 | %2 | %3 | %4 | %5 | %6").arg(QString::fromUtf8(name))
+                                                             .arg(e.acquisitions)
+                                                             .arg(e.waitNsecs / 1e6, 0, 'f', 2)
+                                                             .arg(e.maxWaitNsecs / 1e6, 0, 'f', 2)
+                                                             .arg(e.holdNsecs / 1e6, 0, 'f', 2)
+                                                             .arg(e.maxHoldNsecs / 1e6, 0, 'f', 2);
+    }
+    return lines.join('\n');
+}
+
+qint64 LockStatistics::threadWaitNsecs()
+{
+    return threadWaitTime;
+}
+
+LockTimer::LockTimer(const char* lock)
+    : m_lock(lock)
+{
+    if ( LockStatistics::isEnabled() ) {
+        m_timer.start();
+    }
+}
+
+void LockTimer::acquired()
+{
+    if ( m_timer.isValid() ) {
+        m_waitNsecs = m_timer.nsecsElapsed();
+        m_timer.restart();
+    }
+}
+
+LockTimer::~LockTimer()
+{
+    if ( m_timer.isValid() && m_waitNsecs >= 0 ) {
+        LockStatistics::record(m_lock, m_waitNsecs, m_timer.nsecsElapsed());
+    }
+}
+
+}
@@ -0,0 +1,101 @@
+/*
+    This file is part of kdev-python, the python language plugin for KDevelop
+    Copyright (C) 2026 agent <agent@local>
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef PYTHON_LOCKSTATISTICS_H
+#define PYTHON_LOCKSTATISTICS_H
+
+#include <QByteArray>
+#include <QElapsedTimer>
+#include <QHash>
+#include <QString>
+
+#include "parserexport.h"
+
+namespace Python {
+
+/**
+ * @brief Collects how often the locks used while parsing are taken, and how long they are waited for and held.
+ *
+ * Recording is only done if the KDEV_PYTHON_LOCK_STATISTICS or KDEV_PYTHON_PARSE_PROFILE environment
+ * variable is set; otherwise all functions return immediately.
+ */
+class KDEVPYTHONPARSER_EXPORT LockStatistics
+{
+public:
+    struct Entry {
+        quint64 acquisitions = 0;
+        qint64 waitNsecs = 0;
+        qint64 holdNsecs = 0;
+        qint64 maxWaitNsecs = 0;
+        qint64 maxHoldNsecs = 0;
+    };
+
+    /**
+     * @brief Whether statistics are being recorded in this process.
+     */
+    static bool isEnabled();
+
+    /**
+     * @brief Record one acquisition of the lock called @p lock.
+     */
+    static void record(const char* lock, qint64 waitNsecs, qint64 holdNsecs);
+
+    /**
+     * @brief Get a copy of all data recorded so far, keyed by lock name.
+     */
+    static QHash<QByteArray, Entry> snapshot();
+
+    /**
+     * @brief Discard all data recorded so far.
+     */
+    static void reset();
+
+    /**
+     * @brief Human-readable table of the recorded data, one lock per line.
+     */
+    static QString summary();
+
+    /**
+     * @brief Total time the calling thread has spent waiting for instrumented locks.
+     * Useful to attribute lock waits to a piece of work by taking the difference before and after it.
+     */
+    static qint64 threadWaitNsecs();
+};
+
+/**
+ * @brief Measures a single acquisition of a lock.
+ *
+ * Construct it right before taking the lock, and call acquired() as soon as the lock is held.
+ * The hold time is recorded when the object is destroyed, so it must outlive the locker.
+ */
+class KDEVPYTHONPARSER_EXPORT LockTimer
+{
+public:
+    explicit LockTimer(const char* lock);
+    ~LockTimer();
+    void acquired();
+
+private:
+    const char* m_lock;
+    QElapsedTimer m_timer;
+    qint64 m_waitNsecs = -1;
+};
+
+}
+
+#endif // PYTHON_LOCKSTATISTICS_H
@@ -0,0 +1,258 @@
+/*
+    This file is part of kdev-python, the python language plugin for KDevelop
+    Copyright (C) 2026 agent <agent@local>
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "reversetokenizer.h"
+
+#include <QStringRef>
+
+namespace Python {
+
+namespace {
+
+struct CharClassTable {
+    CharClassTable()
+    {
+        for ( int c = 0; c < 128; c++ ) {
+            classes[c] = ReverseTokenizer::OtherChar;
+            if ( ( c >= 'a' && c <= 'z' ) || ( c >= 'A' && c <= 'Z' ) || ( c >= '0' && c <= '9' ) || c == '_' ) {
+                classes[c] |= ReverseTokenizer::IdentifierChar;
+            }
+        }
+        // same as QChar::isSpace() for latin1
+        add(" \t\n\v\f\r", ReverseTokenizer::SpaceChar);
+        add("([{", ReverseTokenizer::OpeningBracketChar);
+        add(")]}\"'", ReverseTokenizer::ClosingBracketChar);
+        add(",=:*-+/%^~", ReverseTokenizer::SeparatorChar);
+        add(".([", ReverseTokenizer::SliceChar);
+        add(":,({[.=", ReverseTokenizer::ControlChar);
+    }
+    void add(const char* chars, int charClass)
+    {
+        for ( ; *chars; chars++ ) {
+            classes[int(*chars)] |= charClass;
+        }
+    }
+    int classes[128];
+};
+
+const CharClassTable charClasses;
+
+struct KeywordEntry {
+    const char* text;
+    ReverseTokenizer::Keyword keyword;
+};
+
+// Keywords known to me:
+// and       del       for       is        raise
+// assert    elif      from      lambda    return
+// break     else      global    not       try
+// class     except    if        or        while
+// continue  exec      import    pass      yield
+// def       finally   in        print     with
+// async     await
+const KeywordEntry keywords[] = {
+    { "import", ReverseTokenizer::ImportKeyword },
+    { "from", ReverseTokenizer::FromKeyword },
+    { "raise", ReverseTokenizer::RaiseKeyword },
+    { "in", ReverseTokenizer::InKeyword },
+    { "for", ReverseTokenizer::ForKeyword },
+    { "class", ReverseTokenizer::ClassKeyword },
+    { "def", ReverseTokenizer::DefKeyword },
+    { "except", ReverseTokenizer::ExceptKeyword },
+    { "and", ReverseTokenizer::AndKeyword },
+    { "assert", ReverseTokenizer::AssertKeyword },
+    { "del", ReverseTokenizer::DelKeyword },
+    { "elif", ReverseTokenizer::ElifKeyword },
+    { "exec", ReverseTokenizer::ExecKeyword },
+    { "if", ReverseTokenizer::IfKeyword },
+    { "is", ReverseTokenizer::IsKeyword },
+    { "not", ReverseTokenizer::NotKeyword },
+    { "or", ReverseTokenizer::OrKeyword },
+    { "print", ReverseTokenizer::PrintKeyword },
+    { "return", ReverseTokenizer::ReturnKeyword },
+    { "while", ReverseTokenizer::WhileKeyword },
+    { "yield", ReverseTokenizer::YieldKeyword },
+    { "with", ReverseTokenizer::WithKeyword },
+    { "await", ReverseTokenizer::AwaitKeyword },
+    { "break", ReverseTokenizer::BreakKeyword },
+    { "continue", ReverseTokenizer::ContinueKeyword },
+    { "pass", ReverseTokenizer::PassKeyword },
+    { "try", ReverseTokenizer::TryKeyword },
+    { "else", ReverseTokenizer::ElseKeyword },
+    { "as", ReverseTokenizer::AsKeyword },
+    { "finally", ReverseTokenizer::FinallyKeyword },
+    { "global", ReverseTokenizer::GlobalKeyword },
+    { "lambda", ReverseTokenizer::LambdaKeyword }
+};
+
+const int maxKeywordLength = 8;
+
+QChar openingBracketFor(QChar closing)
+{
+    switch ( closing.unicode() ) {
+        case ')': return QLatin1Char('(');
+        case ']': return QLatin1Char('[');
+        case '}': return QLatin1Char('{');
+        default: return closing; // quotes
+    }
+}
+
+// beginning of the line which contains @p pos
+int lineBeginAt(const QString& text, int pos)
+{
+    return pos > 0 ? text.lastIndexOf(QLatin1Char('\n'), pos - 1) + 1 : 0;
+}
+
+}
+
+int ReverseTokenizer::charClass(QChar c)
+{
+    const ushort u = c.unicode();
+    if ( u < 128 ) {
+        return charClasses.classes[u];
+    }
+    if ( c.isSpace() ) {
+        return SpaceChar;
+    }
+    return c.isLetterOrNumber() ? IdentifierChar : OtherChar;
+}
+
+bool ReverseTokenizer::is(QChar c, CharClass charClass)
+{
+    return ReverseTokenizer::charClass(c) & charClass;
+}
+
+ReverseTokenizer::Keyword ReverseTokenizer::keyword(const QString& text, int begin, int end)
+{
+    const int length = end - begin;
+    if ( length < 2 || length > maxKeywordLength ) {
+        return NoKeyword;
+    }
+    const QStringRef word = text.midRef(begin, length);
+    for ( const KeywordEntry& entry: keywords ) {
+        if ( word == QLatin1String(entry.text) ) {
+            return entry.keyword;
+        }
+    }
+    return NoKeyword;
+}
+
+int ReverseTokenizer::expressionStart(const QString& line, int from, ExpressionScan& scan, int lineBegin)
+{
+    for ( int i = from; i >= lineBegin; i-- ) {
+        const QChar c = line.at(i);
+        const int cls = charClass(c);
+        if ( ! scan.brackets.isEmpty() && scan.brackets.last() == c ) {
+            scan.brackets.removeLast();
+        }
+        else if ( cls & ClosingBracketChar ) {
+            scan.brackets.append(openingBracketFor(c));
+        }
+        else if ( cls & OpeningBracketChar ) {
+            return i + 1;
+        }
+
+        if ( scan.brackets.isEmpty() && ( ( (cls & SpaceChar) && ! scan.lastWasSlice ) || (cls & SeparatorChar) ) ) {
+            return i + 1;
+        }
+        // chars which are allowed to be preceded by a space
+        scan.lastWasSlice = cls & SliceChar;
+    }
+    return -1;
+}
+
+ReverseTokenizer::Token ReverseTokenizer::previousToken(const QString& text, int end)
+{
+    Token token;
+    int pos = end;
+    while ( pos > 0 && is(text.at(pos - 1), SpaceChar) ) {
+        if ( text.at(pos - 1) == QLatin1Char('\n') ) {
+            token.type = EmptyLineToken;
+            token.begin = token.end = pos;
+            return token;
+        }
+        pos--;
+    }
+    token.begin = token.end = pos;
+    token.whitespaceAfter = end - pos;
+    if ( pos == 0 ) {
+        return token;
+    }
+
+    if ( is(text.at(pos - 1), ControlChar) ) {
+        token.type = ControlToken;
+        token.begin = pos - 1;
+        return token;
+    }
+
+    if ( token.whitespaceAfter > 0 ) {
+        int wordBegin = pos;
+        while ( wordBegin > 0 && ! is(text.at(wordBegin - 1), SpaceChar) ) {
+            wordBegin--;
+        }
+        token.keyword = keyword(text, wordBegin, pos);
+        if ( token.keyword != NoKeyword ) {
+            token.type = KeywordToken;
+            token.begin = wordBegin;
+            return token;
+        }
+    }
+
+    ExpressionScan scan;
+    int lineBegin = lineBeginAt(text, pos);
+    int start = expressionStart(text, pos - 1, scan, lineBegin);
+    while ( start == -1 ) {
+        if ( lineBegin == 0 ) {
+            start = 0;
+            break;
+        }
+        // the expression continues on the previous line if brackets are open, or if that line ends with a backslash
+        int previousEnd = lineBegin - 1;
+        int previousBegin = lineBeginAt(text, previousEnd);
+        if ( scan.brackets.isEmpty() ) {
+            int last = previousEnd - 1;
+            while ( last >= previousBegin && text.at(last).isSpace() ) {
+                last--;
+            }
+            if ( last < previousBegin || text.at(last) != QLatin1Char('\\') ) {
+                start = lineBegin;
+                break;
+            }
+        }
+        // empty lines are skipped
+        while ( previousBegin == previousEnd && previousBegin > 0 ) {
+            previousEnd = previousBegin - 1;
+            previousBegin = lineBeginAt(text, previousEnd);
+        }
+        if ( previousBegin == previousEnd ) {
+            start = lineBegin;
+            break;
+        }
+        lineBegin = previousBegin;
+        start = expressionStart(text, previousEnd - 1, scan, lineBegin);
+    }
+
+    while ( start < pos && is(text.at(start), SpaceChar) ) {
+        start++;
+    }
+    token.type = ExpressionToken;
+    token.begin = start;
+    return token;
+}
+
+}
@@ -0,0 +1,119 @@
+/*
+    This file is part of kdev-python, the python language plugin for KDevelop
+    Copyright (C) 2026 agent <agent@local>
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef PYTHON_REVERSETOKENIZER_H
+#define PYTHON_REVERSETOKENIZER_H
+
+#include <QString>
+#include <QVarLengthArray>
+
+#include "parserexport.h"
+
+namespace Python {
+
+/**
+ * @brief Splits code into tokens from the back, to find the expression in front of a cursor.
+ *
+ * Characters are classified with a lookup table, and tokens are returned as positions in the
+ * scanned text, so scanning does not allocate memory. Used by CodeHelpers::expressionUnderCursor()
+ * and the completion's ExpressionParser.
+ */
+class KDEVPYTHONPARSER_EXPORT ReverseTokenizer
+{
+public:
+    enum CharClass {
+        OtherChar = 0,
+        IdentifierChar = 1 << 0,
+        SpaceChar = 1 << 1,
+        /// ( [ {
+        OpeningBracketChar = 1 << 2,
+        /// ) ] } and quotes, which close a bracket when scanning backwards
+        ClosingBracketChar = 1 << 3,
+        /// , = : * - + / % ^ ~
+        SeparatorChar = 1 << 4,
+        /// . ( [, which may be preceded by a space inside an expression
+        SliceChar = 1 << 5,
+        /// : , ( { [ . =
+        ControlChar = 1 << 6
+    };
+
+    /// Keywords which end a scanned expression; NoKeyword for other words.
+    enum Keyword {
+        NoKeyword = -1,
+        ImportKeyword, FromKeyword, RaiseKeyword, InKeyword, ForKeyword, ClassKeyword, DefKeyword, ExceptKeyword,
+        AndKeyword, AssertKeyword, DelKeyword, ElifKeyword, ExecKeyword, IfKeyword, IsKeyword, NotKeyword,
+        OrKeyword, PrintKeyword, ReturnKeyword, WhileKeyword, YieldKeyword, WithKeyword, AwaitKeyword,
+        BreakKeyword, ContinueKeyword, PassKeyword, TryKeyword, ElseKeyword, AsKeyword, FinallyKeyword,
+        GlobalKeyword, LambdaKeyword
+    };
+
+    enum TokenType {
+        /// nothing but whitespace before the scanned position
+        NoToken,
+        /// the line before the scanned position is empty
+        EmptyLineToken,
+        /// a single character of the ControlChar class
+        ControlToken,
+        /// a keyword followed by whitespace
+        KeywordToken,
+        /// anything else, as found by expressionStart()
+        ExpressionToken
+    };
+
+    struct Token {
+        TokenType type = NoToken;
+        /// position of the first character
+        int begin = 0;
+        /// position after the last character
+        int end = 0;
+        /// for KeywordToken, which keyword it is
+        Keyword keyword = NoKeyword;
+        /// number of whitespace characters between the token and the scanned position
+        int whitespaceAfter = 0;
+    };
+
+    /// The closing brackets passed while scanning backwards, so scanning can continue on the previous line.
+    struct ExpressionScan {
+        QVarLengthArray<QChar, 32> brackets;
+        bool lastWasSlice = false;
+    };
+
+    static int charClass(QChar c);
+    static bool is(QChar c, CharClass charClass);
+    static Keyword keyword(const QString& text, int begin, int end);
+
+    /**
+     * @brief Scan @p line backwards from @p from (inclusive) for the start of the expression there.
+     *
+     * Scanning stops after an opening bracket which was not closed, and at whitespace and separators outside of brackets.
+     * @return the position of the first character of the expression, or -1 if @p line begins before it is found;
+     * in that case, scanning can continue at the end of the previous line with the same @p scan
+     */
+    static int expressionStart(const QString& line, int from, ExpressionScan& scan, int lineBegin = 0);
+
+    /**
+     * @brief Get the token which ends before @p end in @p text, skipping whitespace.
+     *
+     * Expressions continue on previous lines while brackets are open, or if the previous line ends with a backslash.
+     */
+    static Token previousToken(const QString& text, int end);
+};
+
+}
+
+#endif // PYTHON_REVERSETOKENIZER_H
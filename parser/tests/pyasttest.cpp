@@ -37,6 +37,8 @@
 
 #include "pyasttest.h"
 #include "../astbuilder.h"
+#include "../expressionastbuilder.h"
+#include "../lexicalstatecache.h"
 #include "../parserdebug.h"
 
 #include <ktexteditor_version.h>
@@ -256,6 +258,138 @@ void PyAstTest::testCorrectedFuncRanges_data()
     QTest::newRow("decorate_class") << "class foo:\n @decorate2\n @decorate\n def func(arg): pass" << KTextEditor::Range(3, 5, 3, 8);
 }
 
+// Writes down the structure of a tree, to compare trees built in different ways.
+class StructureVisitor : public AstDefaultVisitor {
+public:
+    void visitNode(Ast* node) override {
+        if ( node ) {
+            structure << QString::number(node->astType);
+        }
+        AstDefaultVisitor::visitNode(node);
+    };
+    void visitIdentifier(Identifier* node) override {
+        if ( node ) {
+            structure << node->value;
+        }
+    };
+    void visitString(StringAst* node) override {
+        structure << node->value;
+    };
+    void visitNumber(NumberAst* node) override {
+        // the value is only meaningful for ints
+        structure << QString::number(node->isInt ? node->value : 0) << QString::number(node->isInt);
+    };
+    void visitNameConstant(NameConstantAst* node) override {
+        structure << QString::number(node->value);
+    };
+    QStringList structure;
+};
+
+void PyAstTest::testExpressionAstBuilder()
+{
+    QFETCH(QString, code);
+    QFETCH(bool, supported);
+    CodeAst::Ptr ast = ExpressionAstBuilder::parse(code);
+    QCOMPARE(static_cast<bool>(ast), supported);
+    if ( ! supported ) {
+        return;
+    }
+    VerifyVisitor v;
+    v.visitCode(ast.data());
+
+    StructureVisitor expected;
+    expected.visitCode(getAst(code).data());
+    StructureVisitor actual;
+    actual.visitCode(ast.data());
+    QCOMPARE(actual.structure, expected.structure);
+}
+
+void PyAstTest::testExpressionAstBuilder_data()
+{
+    QTest::addColumn<QString>("code");
+    QTest::addColumn<bool>("supported");
+
+    QTest::newRow("name") << "foo" << true;
+    QTest::newRow("attribute") << "foo.bar.baz" << true;
+    QTest::newRow("call") << "foo(3, bar, x=\"y\")" << true;
+    QTest::newRow("call_chain") << "foo.bar(1)(2).baz()" << true;
+    QTest::newRow("subscript") << "foo[3].bar" << true;
+    QTest::newRow("nested") << "foo(bar[baz.x], [1, 2.5, None])" << true;
+    QTest::newRow("string_method") << "'a\\'b'.join" << true;
+    QTest::newRow("concatenated_strings") << "\"a\" 'b'.upper()" << true;
+    QTest::newRow("bytes") << "b'abc'.decode" << true;
+    QTest::newRow("tuple") << "(1, 'a', foo)" << true;
+    QTest::newRow("parentheses") << "(foo).bar" << true;
+    QTest::newRow("empty_containers") << "[(), {}, []]" << true;
+    QTest::newRow("dict") << "{'a': 1, 2: [3]}.keys()" << true;
+    QTest::newRow("set") << "{1, 2, 3}.union" << true;
+    QTest::newRow("numbers") << "[0x1f, 0o17, 0b101, 1e5, 3j, .5]" << true;
+    QTest::newRow("multiline") << "foo(1,\n    2)" << true;
+
+    QTest::newRow("operator") << "a + b" << false;
+    QTest::newRow("comprehension") << "[x for x in y]" << false;
+    QTest::newRow("slice") << "foo[1:2]" << false;
+    QTest::newRow("starargs") << "foo(*args)" << false;
+    QTest::newRow("lambda") << "lambda: 3" << false;
+    QTest::newRow("keyword") << "not foo" << false;
+    QTest::newRow("statement") << "a = 3" << false;
+    QTest::newRow("unterminated") << "foo(bar" << false;
+    QTest::newRow("unterminated_string") << "'abc" << false;
+}
+
+void PyAstTest::testLexicalState()
+{
+    QFETCH(QString, code);
+    const LexicalState state = LexicalStateCache::compute(code);
+    for ( int i = 0; i <= code.size(); i++ ) {
+        QCOMPARE(state.locationAt(i), CodeHelpers::endsInside(code.left(i)));
+    }
+    const FileIndentInformation indents(code);
+    QCOMPARE(state.linesCount(), indents.linesCount());
+    for ( int i = 0; i < indents.linesCount(); i++ ) {
+        QCOMPARE(state.indentForLine(i), indents.indentForLine(i));
+    }
+    const KTextEditor::Range range(0, 0, 0, 0);
+    const KTextEditor::Cursor cursor(state.linesCount() - 1, 0);
+    QCOMPARE(state.offsetOfCursor(range, cursor), CodeHelpers::splitCodeByCursor(code, range, cursor).first.size());
+
+    // Typing the code character by character, and then deleting it again, must give the same results
+    // as scanning it from scratch.
+    const QString document = QStringLiteral("testLexicalState");
+    for ( int i = 0; i <= code.size(); i++ ) {
+        const QString typed = code.left(i);
+        const LexicalState cached = LexicalStateCache::state(document, typed);
+        const LexicalState fresh = LexicalStateCache::compute(typed);
+        QCOMPARE(cached.endLocation(), CodeHelpers::endsInside(typed));
+        QCOMPARE(cached.lastStatementOffset(), fresh.lastStatementOffset());
+        QCOMPARE(cached.linesCount(), fresh.linesCount());
+        for ( int line = 0; line < fresh.linesCount(); line++ ) {
+            QCOMPARE(cached.line(line).offset, fresh.line(line).offset);
+            QCOMPARE(cached.line(line).indent, fresh.line(line).indent);
+            QCOMPARE(cached.line(line).bracketDepth, fresh.line(line).bracketDepth);
+            QCOMPARE(cached.line(line).openString, fresh.line(line).openString);
+            QCOMPARE(cached.line(line).continued, fresh.line(line).continued);
+        }
+    }
+    for ( int i = code.size(); i >= 0; i-- ) {
+        const QString typed = code.left(i);
+        QCOMPARE(LexicalStateCache::state(document, typed).endLocation(), CodeHelpers::endsInside(typed));
+    }
+}
+
+void PyAstTest::testLexicalState_data()
+{
+    QTest::addColumn<QString>("code");
+
+    QTest::newRow("code") << "def foo(a, b):\n    return a.b\n";
+    QTest::newRow("comment") << "x = 3 # it's a comment\n  y = 'abc' # \"\n";
+    QTest::newRow("strings") << "a = 'x\\'y' + \"\\\"\" + '''\nfoo ' \" bar\n''' + \"\"\"\"\"\"\n# done";
+    QTest::newRow("unterminated") << "a = \"\"\"foo\n   bar";
+    QTest::newRow("brackets") << "foo(1,\n    [2, 3,\n     4])\nbar = {\n  'a': (1, 2)}\n";
+    QTest::newRow("continuation") << "x = 1 + \\\n    2\nif a and \\\n   b:\n\tpass";
+    QTest::newRow("empty_lines") << "\n\n   \n\t\nx\n";
+}
+
 void PyAstTest::testNewPython3()
 {
     QFETCH(QString, code);
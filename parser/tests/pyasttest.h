@@ -53,6 +53,10 @@ private slots:
     void testExceptionHandlers();
     void testCorrectedFuncRanges();
     void testCorrectedFuncRanges_data();
+    void testExpressionAstBuilder();
+    void testExpressionAstBuilder_data();
+    void testLexicalState();
+    void testLexicalState_data();
 };
 
 }
@@ -0,0 +1,208 @@
+/************************************************************************
+ * KDevelop4 Python Language Support                                    *
+ *                                                                      *
+ * Copyright 2026 agent <agent@local>                                   *
+ *                                                                      *
+ * This program is free software; you can redistribute it and/or modify *
+ * it under the terms of the GNU General Public License as published by *
+ * the Free Software Foundation; either version 2 or version 3 of the   *
+ * License, or (at your option) any later version.                      *
+ *                                                                      *
+ * This program is distributed in the hope that it will be useful, but  *
+ * WITHOUT ANY WARRANTY; without even the implied warranty of           *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU     *
+ * General Public License for more details.                             *
+ *                                                                      *
+ * You should have received a copy of the GNU General Public License    *
+ * along with this program; if not, see <http://www.gnu.org/licenses/>. *
+ ************************************************************************/
+
+#include "pep8checker.h"
+
+#include "kcm_pep8.h"
+#include "pythonparsejob.h"
+#include "duchain/parseprofiler.h"
+
+#include <language/duchain/duchain.h>
+#include <language/duchain/duchainlock.h>
+#include <language/duchain/parsingenvironment.h>
+#include <language/duchain/topducontext.h>
+#include <interfaces/icore.h>
+#include <interfaces/idocument.h>
+#include <interfaces/idocumentcontroller.h>
+#include <serialization/indexedstring.h>
+
+#include <KConfig>
+#include <KConfigGroup>
+#include <KLocalizedString>
+#include <KShell>
+#include <KTextEditor/Document>
+
+#include <QFileInfo>
+#include <QProcess>
+#include <QRegularExpression>
+#include <QTimer>
+
+#include <QDebug>
+#include "pythondebug.h"
+
+using namespace KDevelop;
+
+namespace Python {
+
+PEP8Checker::PEP8Checker(QObject* parent)
+    : QObject(parent)
+{
+}
+
+PEP8Checker::~PEP8Checker()
+{
+    foreach ( const Check& check, m_running ) {
+        check.process->disconnect(this);
+        check.process->kill();
+        check.process->waitForFinished(100);
+    }
+}
+
+void PEP8Checker::scheduleCheck(const QUrl& document)
+{
+    QMetaObject::invokeMethod(this, "startCheck", Qt::QueuedConnection, Q_ARG(QUrl, document));
+}
+
+void PEP8Checker::startCheck(const QUrl& document)
+{
+    if ( m_running.contains(document) ) {
+        // the result of the running check will be outdated, so run again once it finished
+        m_pending.insert(document);
+        return;
+    }
+    IDocument* idoc = ICore::self()->documentController()->documentForUrl(document);
+    if ( ! idoc || ! idoc->textDocument() ) {
+        return;
+    }
+    KConfig config("kdevpythonsupportrc");
+    KConfigGroup configGroup = config.group("pep8");
+    if ( ! PEP8KCModule::isPep8Enabled(configGroup) ) {
+        return;
+    }
+
+    Check check;
+    check.executable = PEP8KCModule::pep8Path(configGroup);
+    check.revision = ModificationRevision::revisionForFile(IndexedString(document));
+    const QFileInfo f(check.executable);
+    if ( check.executable.isEmpty() || ! f.isExecutable() ) {
+        // don't bother executing an invalid executable
+        return;
+    }
+
+    qCDebug(KDEV_PYTHON) << "doing pep8 checking for" << document;
+    check.process = new QProcess(this);
+    check.process->setProcessChannelMode(QProcess::MergedChannels);
+    connect(check.process, static_cast<void(QProcess::*)(int, QProcess::ExitStatus)>(&QProcess::finished),
+            this, [this, document]() { checkFinished(document); });
+    connect(check.process, static_cast<void(QProcess::*)(QProcess::ProcessError)>(&QProcess::error),
+            this, [this, document](QProcess::ProcessError error) {
+        if ( error == QProcess::FailedToStart ) {
+            checkFinished(document);
+        }
+    });
+    // a checker which hangs must not block checking this document forever
+    QTimer::singleShot(10000, check.process, [check]() { check.process->kill(); });
+    check.started = ParseProfiler::now();
+    m_running.insert(document, check);
+
+    // "-" makes the checker read the file contents from stdin
+    check.process->start(check.executable, QStringList{"-"} << KShell::splitArgs(PEP8KCModule::pep8Arguments(configGroup)));
+    check.process->write(idoc->textDocument()->text().toUtf8());
+    check.process->closeWriteChannel();
+}
+
+void PEP8Checker::checkFinished(const QUrl& document)
+{
+    if ( ! m_running.contains(document) ) {
+        return;
+    }
+    const Check check = m_running.take(document);
+    check.process->deleteLater();
+    ParseProfiler::record(IndexedString(document).str(), ParseProfiler::PEP8, check.started, ParseProfiler::now() - check.started);
+
+    if ( m_pending.remove(document) ) {
+        // the document was reparsed while this was running; the newer check supersedes this one
+        startCheck(document);
+        return;
+    }
+
+    bool works = check.process->error() != QProcess::FailedToStart
+                 && check.process->exitStatus() == QProcess::NormalExit
+                 && ( check.process->exitCode() == 0 || check.process->exitCode() == 1 );
+    const QByteArray output = works ? check.process->readAll() : QByteArray();
+    auto problems = parseOutput(document, output);
+    if ( ! works ) {
+        KDevelop::Problem *p = new KDevelop::Problem();
+        p->setFinalLocation(DocumentRange(IndexedString(document), KTextEditor::Range(0, 0, 0, 0)));
+        p->setSource(KDevelop::IProblem::Preprocessor);
+        p->setSeverity(KDevelop::IProblem::Warning);
+        p->setDescription(i18n("The selected PEP8 syntax checker \"%1\" does not seem to work correctly.", check.executable));
+        problems.append(ProblemPointer(p));
+    }
+    attachProblems(document, check.revision, problems);
+}
+
+QList<ProblemPointer> PEP8Checker::parseOutput(const QUrl& document, const QByteArray& output) const
+{
+    static const QRegularExpression errorFormat("^(.*):(\\d+):(\\d+): (.*)$");
+    const IndexedString indexedDocument(document);
+    QList<ProblemPointer> problems;
+    foreach ( const QByteArray& line, output.split('\n') ) {
+        if ( line.isEmpty() ) {
+            continue;
+        }
+        const auto match = errorFormat.match(QString::fromUtf8(line));
+        if ( ! match.hasMatch() ) {
+            qCDebug(KDEV_PYTHON) << "invalid pep8 error line:" << line;
+            continue;
+        }
+        const int lineno = match.captured(2).toInt();
+        const int colno = match.captured(3).toInt();
+        const QString error = match.captured(4);
+        KDevelop::Problem *p = new KDevelop::Problem();
+        p->setFinalLocation(DocumentRange(indexedDocument, KTextEditor::Range(lineno - 1, qMax(colno - 4, 0),
+                                                                             lineno - 1, colno + 4)));
+        p->setSource(KDevelop::IProblem::Preprocessor);
+        p->setSeverity(error.startsWith('W') ? KDevelop::IProblem::Hint : KDevelop::IProblem::Warning);
+        p->setDescription(i18n("PEP8 checker error: %1", error));
+        problems.append(ProblemPointer(p));
+    }
+    return problems;
+}
+
+void PEP8Checker::attachProblems(const QUrl& document, const ModificationRevision& revision,
+                                 const QList<ProblemPointer>& problems)
+{
+    const IndexedString indexedDocument(document);
+    ReferencedTopDUContext topContext;
+    {
+        DUChainWriteLocker lock;
+        topContext = DUChain::self()->chainForDocument(indexedDocument);
+        if ( ! topContext || ! topContext->parsingEnvironmentFile() ) {
+            return;
+        }
+        if ( topContext->parsingEnvironmentFile()->modificationRevision() != revision ) {
+            // the checked text is not the one the context was built from; the parse job for
+            // the current text will request another check
+            qCDebug(KDEV_PYTHON) << "dropping outdated pep8 results for" << document;
+            return;
+        }
+        if ( topContext->features() & ParseJob::PEP8Checking ) {
+            // results for this revision were attached already
+            return;
+        }
+        topContext->setFeatures(static_cast<TopDUContext::Features>(topContext->features() | ParseJob::PEP8Checking));
+        foreach ( const ProblemPointer& problem, problems ) {
+            topContext->addProblem(problem);
+        }
+    }
+    DUChain::self()->emitUpdateReady(indexedDocument, topContext);
+}
+
+}
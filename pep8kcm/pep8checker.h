@@ -0,0 +1,78 @@
+/************************************************************************
+ * KDevelop4 Python Language Support                                    *
+ *                                                                      *
+ * Copyright 2026 agent <agent@local>                                   *
+ *                                                                      *
+ * This program is free software; you can redistribute it and/or modify *
+ * it under the terms of the GNU General Public License as published by *
+ * the Free Software Foundation; either version 2 or version 3 of the   *
+ * License, or (at your option) any later version.                      *
+ *                                                                      *
+ * This program is distributed in the hope that it will be useful, but  *
+ * WITHOUT ANY WARRANTY; without even the implied warranty of           *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU     *
+ * General Public License for more details.                             *
+ *                                                                      *
+ * You should have received a copy of the GNU General Public License    *
+ * along with this program; if not, see <http://www.gnu.org/licenses/>. *
+ ************************************************************************/
+
+#ifndef PEP8CHECKER_H
+#define PEP8CHECKER_H
+
+#include <QHash>
+#include <QObject>
+#include <QSet>
+#include <QUrl>
+
+#include <language/duchain/problem.h>
+#include <language/editor/modificationrevision.h>
+
+class QProcess;
+
+namespace Python {
+
+/**
+ * @brief Runs the PEP8 checker on open documents, without blocking the parse jobs.
+ *
+ * The document text is passed to the checker on stdin, and the process is handled asynchronously
+ * in the main thread. When it finishes, the problems are attached to the document's top context,
+ * unless the document was reparsed for a different revision in the meantime.
+ * Checks requested while one is running for the same document are coalesced into one more run.
+ */
+class PEP8Checker : public QObject
+{
+    Q_OBJECT
+public:
+    explicit PEP8Checker(QObject* parent = nullptr);
+    ~PEP8Checker() override;
+
+    /**
+     * @brief Check @p document if it is open in the editor and checking is enabled.
+     * Can be called from any thread; the check itself is started in the main thread.
+     */
+    void scheduleCheck(const QUrl& document);
+
+private slots:
+    void startCheck(const QUrl& document);
+
+private:
+    struct Check {
+        QProcess* process;
+        KDevelop::ModificationRevision revision;
+        QString executable;
+        qint64 started;
+    };
+    void checkFinished(const QUrl& document);
+    QList<KDevelop::ProblemPointer> parseOutput(const QUrl& document, const QByteArray& output) const;
+    void attachProblems(const QUrl& document, const KDevelop::ModificationRevision& revision,
+                        const QList<KDevelop::ProblemPointer>& problems);
+
+    QHash<QUrl, Check> m_running;
+    // documents for which a check was requested while one was running
+    QSet<QUrl> m_pending;
+};
+
+}
+
+#endif
@@ -22,16 +22,112 @@
 #include <language/duchain/declaration.h>
 #include <language/duchain/types/abstracttype.h>
 #include <language/duchain/declaration.h>
+#include <language/duchain/duchainlock.h>
+#include <language/duchain/parsingenvironment.h>
+#include <language/duchain/use.h>
+#include <language/highlighting/colorcache.h>
+
+#include <QMutexLocker>
 
 using namespace KDevelop;
 
 namespace Python
 {
 
+namespace {
+void combine(quint64& hash, quint64 value)
+{
+    hash = hash * 1099511628211ULL + value;
+}
+
+void combine(quint64& hash, const RangeInRevision& range)
+{
+    combine(hash, range.start.line);
+    combine(hash, range.start.column);
+    combine(hash, range.end.line);
+    combine(hash, range.end.column);
+}
+
+void combine(quint64& hash, const Declaration* declaration)
+{
+    if ( ! declaration ) {
+        combine(hash, 0);
+        return;
+    }
+    // everything the colour of a declaration or of its uses depends on
+    combine(hash, declaration->qualifiedIdentifier().index());
+    combine(hash, declaration->kind());
+    combine(hash, declaration->indexedType().hash());
+    combine(hash, declaration->internalContext() != nullptr);
+    combine(hash, declaration->context()->type());
+}
+
+// Must be called with the duchain locked.
+void fingerprint(quint64& hash, const DUContext* context)
+{
+    combine(hash, context->type());
+    combine(hash, context->range());
+    foreach ( const Declaration* declaration, context->localDeclarations() ) {
+        combine(hash, declaration->range());
+        combine(hash, declaration);
+    }
+    const TopDUContext* top = context->topContext();
+    for ( int i = 0; i < context->usesCount(); i++ ) {
+        const Use& use = context->uses()[i];
+        combine(hash, use.m_range);
+        combine(hash, use.usedDeclaration(const_cast<TopDUContext*>(top)));
+    }
+    foreach ( const DUContext* child, context->childContexts() ) {
+        fingerprint(hash, child);
+    }
+}
+}
+
 Highlighting::Highlighting( QObject * parent )
        : KDevelop::CodeHighlighting(parent)
 {
-    
+    // the colours are part of the highlighting, but not of the fingerprints
+    connect(ColorCache::self(), &ColorCache::colorsGotChanged,
+            this, &Highlighting::clearFingerprints);
+}
+
+void Highlighting::highlightDUChain(ReferencedTopDUContext context)
+{
+    IndexedString document;
+    Fingerprint current;
+    current.hash = 14695981039346656037ULL;
+    {
+        DUChainReadLocker lock;
+        if ( ! context ) {
+            return;
+        }
+        document = context->url();
+        if ( ParsingEnvironmentFilePointer file = context->parsingEnvironmentFile() ) {
+            current.revision = file->modificationRevision().revision;
+        }
+        fingerprint(current.hash, context.data());
+    }
+    {
+        QMutexLocker lock(&m_fingerprintsMutex);
+        // The existing highlighting is only kept if the new context was parsed from the same revision of the
+        // document as the highlighted one. Otherwise, the document was edited in between, and the edits might
+        // have moved or collapsed the highlighted ranges, even if the new context looks exactly the same.
+        // The document might also have been closed and re-opened, which discards its highlighting.
+        const auto previous = m_fingerprints.constFind(document);
+        const bool unchanged = previous != m_fingerprints.constEnd() && previous->hash == current.hash
+                               && previous->revision == current.revision && current.revision != -1;
+        m_fingerprints.insert(document, current);
+        if ( unchanged && hasHighlighting(document) ) {
+            return;
+        }
+    }
+    KDevelop::CodeHighlighting::highlightDUChain(context);
+}
+
+void Highlighting::clearFingerprints()
+{
+    QMutexLocker lock(&m_fingerprintsMutex);
+    m_fingerprints.clear();
 }
 
 void CodeHighlightingInstance::highlightUse(KDevelop::DUContext* context, int index, const QColor& color)
@@ -23,6 +23,7 @@
 #include <QObject>
 #include <QHash>
 #include <QModelIndex>
+#include <QMutex>
 
 #include <language/highlighting/codehighlighting.h>
 #include <language/duchain/topducontext.h>
@@ -50,6 +51,28 @@ Q_OBJECT
 public:
     Highlighting( QObject* parent );
     CodeHighlightingInstance* createInstance() const override;
+
+    /**
+     * @brief Highlight @p context, unless nothing which affects the highlighting changed since it was last highlighted.
+     *
+     * Many reparses (e.g. when a document was found to be up to date, or was reparsed because one of
+     * its imports changed) produce the same declarations and uses from the same text as before;
+     * the document's highlighting is kept as-is then.
+     */
+    void highlightDUChain(KDevelop::ReferencedTopDUContext context) override;
+
+private slots:
+    void clearFingerprints();
+
+private:
+    mutable QMutex m_fingerprintsMutex;
+    struct Fingerprint {
+        quint64 hash = 0;
+        // revision of the document the highlighted context was parsed from
+        int revision = -1;
+    };
+    // state of each top context when it was last highlighted
+    QHash<KDevelop::IndexedString, Fingerprint> m_fingerprints;
 };
 }
 #endif
@@ -22,6 +22,9 @@
 
 #include <QMutexLocker>
 #include <QReadWriteLock>
+#include <QRunnable>
+
+#include <algorithm>
 
 #include <KPluginFactory>
 #include <KPluginLoader>
@@ -42,8 +45,13 @@
 #include <language/interfaces/editorcontext.h>
 #include <language/duchain/duchain.h>
 #include <language/duchain/duchainlock.h>
+#include <language/backgroundparser/backgroundparser.h>
 #include <language/codecompletion/codecompletion.h>
 #include <language/codecompletion/codecompletionmodel.h>
+#include <project/projectmodel.h>
+#include <util/path.h>
+
+#include <custom-definesandincludes/idefinesandincludesmanager.h>
 
 #include "pythonparsejob.h"
 #include "pythonhighlighting.h"
@@ -53,7 +61,15 @@
 #include "codegen/correctionfilegenerator.h"
 #include "kdevpythonversion.h"
 #include "pep8kcm/kcm_pep8.h"
+#include "pep8kcm/pep8checker.h"
 #include "docfilekcm/kcm_docfiles.h"
+#include "lockstatistics.h"
+#include "duchain/importgraph.h"
+#include "duchain/parseprofiler.h"
+#include "duchain/projectpaths.h"
+#include "duchain/helpers.h"
+#include "duchain/correctionfileindex.h"
+#include "duchain/moduleindex.h"
 
 #include <QDebug>
 #include "pythondebug.h"
@@ -66,6 +82,50 @@ namespace Python
 {
 LanguageSupport* LanguageSupport::m_self = 0;
 
+namespace {
+/**
+ * @brief Scans the imports of a list of files, and queues the files for parsing, imported ones first.
+ */
+class ImportGraphScheduler : public QRunnable
+{
+public:
+    ImportGraphScheduler(const QList<QUrl>& files)
+        : m_files(files)
+    { }
+
+    void run() override
+    {
+        const auto levels = ImportGraph::fromFiles(m_files).levels();
+        QVector<QPair<int, QUrl>> order;
+        order.reserve(levels.size());
+        for ( auto it = levels.constBegin(); it != levels.constEnd(); it++ ) {
+            order.append(qMakePair(it.value(), it.key()));
+        }
+        std::sort(order.begin(), order.end());
+
+        // Lower levels get better priorities, and sequential processing makes the background parser
+        // finish each level before it starts the next one; thus the imports of a file are available
+        // when it is parsed, and it doesn't need to be rescheduled. All of this goes before the project
+        // controller's initial parse, which queues the same files with InitialParsePriority.
+        static const int maxLevels = 1000;
+        auto parser = ICore::self()->languageController()->backgroundParser();
+        foreach ( const auto& entry, order ) {
+            if ( ICore::self()->shuttingDown() ) {
+                return;
+            }
+            const int priority = BackgroundParser::InitialParsePriority - maxLevels + qMin(entry.first, maxLevels - 1);
+            parser->addDocument(IndexedString(entry.second), TopDUContext::VisibleDeclarationsAndContexts,
+                                priority, nullptr, ParseJob::FullSequentialProcessing);
+        }
+        qCDebug(KDEV_PYTHON) << "scheduled" << order.size() << "files in import order,"
+                             << ( order.isEmpty() ? 0 : order.last().first + 1 ) << "levels";
+    }
+
+private:
+    const QList<QUrl> m_files;
+};
+}
+
 KDevelop::ContextMenuExtension LanguageSupport::contextMenuExtension(KDevelop::Context* context)
 {
     ContextMenuExtension cm;
@@ -84,6 +144,7 @@ LanguageSupport::LanguageSupport( QObject* parent, const QVariantList& /*args*/
     , KDevelop::ILanguageSupport()
     , m_highlighting( new Highlighting( this ) )
     , m_refactoring( new Refactoring( this ) )
+    , m_pep8Checker( new PEP8Checker( this ) )
 {
     KDEV_USE_EXTENSION_INTERFACE( KDevelop::ILanguageSupport )
     KDEV_USE_EXTENSION_INTERFACE( KDevelop::ILanguageCheckProvider )
@@ -98,6 +159,70 @@ LanguageSupport::LanguageSupport( QObject* parent, const QVariantList& /*args*/
 
     QObject::connect(ICore::self()->documentController(), &IDocumentController::documentOpened,
                      this, &LanguageSupport::documentOpened);
+    QObject::connect(ICore::self()->projectController(), &IProjectController::projectOpened,
+                     this, &LanguageSupport::projectOpened);
+    QObject::connect(ICore::self()->projectController(), &IProjectController::projectClosed,
+                     this, &LanguageSupport::projectClosed);
+    // the include paths might have been changed in the project configuration
+    QObject::connect(ICore::self()->projectController(), &IProjectController::projectConfigurationChanged,
+                     this, [this]() { updateProjectPaths(); });
+    updateProjectPaths();
+    m_importScanPool.setMaxThreadCount(1);
+    // create the indices in the main thread, so their file watchers work
+    CorrectionFileIndex::self();
+    ModuleIndex::self();
+
+    // Queue the built-in documentation right away: every python file imports it, and files parsed
+    // before it is available must be parsed a second time. If it is already in the (persistent) duchain
+    // and up to date, the parse job returns immediately.
+    const auto documentation = IndexedString(Helper::getDocumentationFile());
+    if ( ! documentation.isEmpty() ) {
+        core()->languageController()->backgroundParser()->addDocument(documentation,
+                                                                      TopDUContext::VisibleDeclarationsAndContexts,
+                                                                      BackgroundParser::BestPriority);
+    }
+}
+
+void LanguageSupport::projectOpened(IProject* project)
+{
+    updateProjectPaths();
+    if ( ! IProjectController::parseAllProjectSources() ) {
+        return;
+    }
+    QList<QUrl> files;
+    foreach ( const IndexedString& file, project->fileSet() ) {
+        if ( file.str().endsWith(QLatin1String(".py")) || file.str().endsWith(QLatin1String(".pyx")) ) {
+            files.append(file.toUrl());
+        }
+    }
+    if ( ! files.isEmpty() ) {
+        m_importScanPool.start(new ImportGraphScheduler(files));
+    }
+}
+
+void LanguageSupport::projectClosed(IProject* project)
+{
+    updateProjectPaths(project);
+}
+
+void LanguageSupport::updateProjectPaths(IProject* closing)
+{
+    IDefinesAndIncludesManager* iface = IDefinesAndIncludesManager::manager();
+    QVector<ProjectPaths::Project> projects;
+    foreach ( IProject* project, core()->projectController()->projects() ) {
+        if ( project == closing ) {
+            continue;
+        }
+        ProjectPaths::Project paths;
+        paths.root = QUrl::fromLocalFile(project->path().path());
+        if ( iface ) {
+            foreach ( const Path& path, iface->includes(project->projectItem(), IDefinesAndIncludesManager::UserDefined) ) {
+                paths.includes.append(path.toUrl());
+            }
+        }
+        projects.append(paths);
+    }
+    ProjectPaths::update(projects);
 }
 
 void LanguageSupport::documentOpened(IDocument* doc)
@@ -107,20 +232,31 @@ void LanguageSupport::documentOpened(IDocument* doc)
         return;
     }
 
-    DUChainReadLocker lock;
-    TopDUContextPointer topContext = TopDUContextPointer(DUChain::self()->chainForDocument(doc->url()));
-    lock.unlock();
-    ParseJob::eventuallyDoPEP8Checking(IndexedString(doc->url()), topContext.data());
+    m_pep8Checker->scheduleCheck(doc->url());
+}
+
+PEP8Checker* LanguageSupport::pep8Checker() const
+{
+    return m_pep8Checker;
 }
 
 LanguageSupport::~LanguageSupport()
 {
+    m_importScanPool.clear();
+    m_importScanPool.waitForDone();
+    ModuleIndex::self()->shutdown();
+
     parseLock()->lockForWrite();
     // By locking the parse-mutexes, we make sure that parse jobs get a chance to finish in a good state
     parseLock()->unlock();
 
     delete m_highlighting;
     m_highlighting = 0;
+
+    ParseProfiler::writeConfiguredOutput();
+    if ( LockStatistics::isEnabled() ) {
+        qDebug().noquote() << "lock statistics:\n" << LockStatistics::summary();
+    }
 }
 
 KDevelop::ParseJob *LanguageSupport::createParseJob( const IndexedString& url )
@@ -168,12 +304,31 @@ BasicRefactoring* LanguageSupport::refactoring() const
     return m_refactoring;
 }
 
+void LanguageSupport::setLastParseDuration(const IndexedString& document, int msecs)
+{
+    QMutexLocker lock(&m_parseDurationsMutex);
+    m_parseDurations.insert(document, msecs);
+}
+
 int LanguageSupport::suggestedReparseDelayForChange(KTextEditor::Document* doc, const KTextEditor::Range& changedRange,
                                                     const QString& changedText, bool /*removal*/) const
 {
+    // Documents which take long to parse are not reparsed more often than it takes to parse them.
+    // Since each change restarts the delay, a burst of edits (e.g. several pastes) then results in a single parse.
+    const int instantParseThreshold = 100;
+    const int maximumDelay = 3000;
+    int lastParseDuration = 0;
+    {
+        QMutexLocker lock(&m_parseDurationsMutex);
+        lastParseDuration = m_parseDurations.value(IndexedString(doc->url()));
+    }
+
     if ( changedRange.start().line() != changedRange.end().line() ) {
-        // instant update
-        return 0;
+        if ( lastParseDuration < instantParseThreshold ) {
+            // instant update
+            return 0;
+        }
+        return qMin(lastParseDuration, maximumDelay);
     }
     if ( std::all_of(changedText.begin(), changedText.end(), [](const QChar& c) { return c.isSpace(); }) ) {
         qDebug() << changedText << changedRange.end().column() << doc->lineLength(changedRange.end().line());
@@ -181,6 +336,10 @@ int LanguageSupport::suggestedReparseDelayForChange(KTextEditor::Document* doc,
             return ILanguageSupport::NoUpdateRequired;
         }
     }
+    // the default delay is half a second, unless configured otherwise
+    if ( lastParseDuration > 500 ) {
+        return qMin(lastParseDuration, maximumDelay);
+    }
     return ILanguageSupport::DefaultDelay;
 }
 
@@ -25,11 +25,17 @@
 #include <interfaces/ilanguagecheckprovider.h>
 #include <language/interfaces/ilanguagesupport.h>
 #include <QtCore/QVariant>
+#include <QHash>
+#include <QMutex>
+#include <QThreadPool>
+
+#include <serialization/indexedstring.h>
 
 namespace KDevelop
 {
 class ParseJob;
 class IDocument;
+class IProject;
 class ICodeHighlighting;
 }
 
@@ -38,6 +44,7 @@ namespace Python
 
 class Highlighting;
 class Refactoring;
+class PEP8Checker;
 
 class LanguageSupport
     : public KDevelop::IPlugin
@@ -73,15 +80,31 @@ public:
 
     QList<KDevelop::ILanguageCheck*> providedChecks() override;
 
+    /// The PEP8 checker service for documents open in the editor.
+    PEP8Checker* pep8Checker() const;
+
+    /// Remember how long the last parse of @p document took; used to choose the reparse delay.
+    void setLastParseDuration(const KDevelop::IndexedString& document, int msecs);
+
     int configPages() const override;
     KDevelop::ConfigPage* configPage(int number, QWidget* parent) override;
 
 public slots:
     void documentOpened(KDevelop::IDocument*);
+    /// Queue the project's files for parsing in the order given by their imports.
+    void projectOpened(KDevelop::IProject* project);
+    void projectClosed(KDevelop::IProject* project);
+    /// Publish the paths of all open projects except @p closing for resolving imports.
+    void updateProjectPaths(KDevelop::IProject* closing = nullptr);
 
 private:
     Highlighting* m_highlighting;
     Refactoring *m_refactoring;
+    PEP8Checker* m_pep8Checker;
+    // runs the import scans for projectOpened()
+    QThreadPool m_importScanPool;
+    mutable QMutex m_parseDurationsMutex;
+    QHash<KDevelop::IndexedString, int> m_parseDurations;
     static LanguageSupport* m_self;
 };
 
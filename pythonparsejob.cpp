@@ -26,9 +26,11 @@
 #include "pythonlanguagesupport.h"
 #include "declarationbuilder.h"
 #include "usebuilder.h"
-#include "kshell.h"
 #include "duchain/helpers.h"
-#include "pep8kcm/kcm_pep8.h"
+#include "pep8kcm/pep8checker.h"
+#include "lockstatistics.h"
+#include "duchain/parseprofiler.h"
+#include "duchain/timedlocker.h"
 
 #include <language/duchain/duchainlock.h>
 #include <language/duchain/duchain.h>
@@ -53,41 +55,67 @@
 
 #include <ktexteditor/document.h>
 
+#include <QCryptographicHash>
+#include <QElapsedTimer>
+#include <QMutex>
+#include <QMutexLocker>
 #include <QReadLocker>
 #include <QFile>
 #include <QThread>
-#include <QProcess>
-#include <QTemporaryFile>
 #include <QDebug>
-#include <KConfigGroup>
-
-#include <custom-definesandincludes/idefinesandincludesmanager.h>
 
 using namespace KDevelop;
 
 namespace Python
 {
 
+namespace {
+// Hash of each document's contents as of its last successful parse in this session,
+// used to recognize files which were touched but not changed.
+QMutex contentHashesMutex;
+QHash<IndexedString, QByteArray> contentHashes;
+
+QByteArray lastParsedContentHash(const IndexedString& document)
+{
+    QMutexLocker lock(&contentHashesMutex);
+    return contentHashes.value(document);
+}
+
+void setLastParsedContentHash(const IndexedString& document, const QByteArray& hash)
+{
+    QMutexLocker lock(&contentHashesMutex);
+    if ( hash.isEmpty() ) {
+        contentHashes.remove(document);
+    }
+    else {
+        contentHashes.insert(document, hash);
+    }
+}
+}
+
 ParseJob::ParseJob(const IndexedString &url, ILanguageSupport* languageSupport)
         : KDevelop::ParseJob(url, languageSupport)
         , m_ast(0)
         , m_duContext(0)
 {
-    IDefinesAndIncludesManager* iface = IDefinesAndIncludesManager::manager();
-    auto project = ICore::self()->projectController()->findProjectForUrl(url.toUrl());
-    if ( project ) {
-        foreach (Path path, iface->includes(project->projectItem(), IDefinesAndIncludesManager::UserDefined)) {
-            m_cachedCustomIncludes.append(path.toUrl());
-        }
-        QMutexLocker lock(&Helper::cacheMutex);
-        Helper::cachedCustomIncludes[project] = m_cachedCustomIncludes;
-    }
 }
 
 ParseJob::~ParseJob()
 {
 }
 
+void ParseJob::abortIncompleteBuild()
+{
+    // The builders stop half-way through the tree when the job is aborted (for the declaration builder,
+    // only when building a new context). Make sure the next job does not consider it up to date.
+    setLastParsedContentHash(document(), QByteArray());
+    if ( m_duContext ) {
+        TimedDUChainWriteLocker lock("DUChain write lock (ParseJob)");
+        m_duContext->parsingEnvironmentFile()->setModificationRevision(ModificationRevision());
+    }
+    abortJob();
+}
+
 CodeAst *ParseJob::ast() const
 {
     Q_ASSERT( isFinished() && m_ast );
@@ -103,43 +131,68 @@ void ParseJob::run(ThreadWeaver::JobPointer /*self*/, ThreadWeaver::Thread* /*th
     
     qDebug() << " ====> PARSING ====> parsing file " << document().toUrl() << "; has priority" << parsePriority();
 
-    {
-        QMutexLocker l(&Helper::projectPathLock);
-        Helper::projectSearchPaths.clear();
-        foreach  (IProject* project, ICore::self()->projectController()->projects() ) {
-            Helper::projectSearchPaths.append(QUrl::fromLocalFile(project->path().path()));
-        }
-    }
-    
     // lock the URL so no other parse job can run on this document
     QReadLocker parselock(languageSupport()->parseLock());
     UrlParseLock urlLock(document());
 
-    readContents();
+    const QString profiledFile = document().str();
+    const qint64 jobStart = ParseProfiler::now();
+    const qint64 lockWaitAtStart = LockStatistics::threadWaitNsecs();
+
+    {
+        ParseProfilerScope profile(profiledFile, ParseProfiler::ReadContents);
+        readContents();
+    }
     
+    const QByteArray contentHash = QCryptographicHash::hash(contents().contents, QCryptographicHash::Md5);
     if ( !(minimumFeatures() & TopDUContext::ForceUpdate || minimumFeatures() & Rescheduled) ) {
-        DUChainReadLocker lock(DUChain::lock());
-        static const IndexedString langString("python");
-        foreach(const ParsingEnvironmentFilePointer &file, DUChain::self()->allEnvironmentFiles(document())) {
-            if ( file->language() != langString ) {
-                continue;
-            }
-            if ( ! file->needsUpdate() && file->featuresSatisfied(minimumFeatures()) && file->topContext() ) {
-                qDebug() << " ====> NOOP    ====> Already up to date:" << document().str();
-                setDuChain(file->topContext());
-                if ( ICore::self()->languageController()->backgroundParser()->trackerForUrl(document()) ) {
-                    lock.unlock();
-                    highlightDUChain();
+        ReferencedTopDUContext upToDate;
+        ParsingEnvironmentFilePointer unchangedContents;
+        {
+            TimedDUChainReadLocker lock("DUChain read lock (ParseJob)");
+            static const IndexedString langString("python");
+            foreach(const ParsingEnvironmentFilePointer &file, DUChain::self()->allEnvironmentFiles(document())) {
+                if ( file->language() != langString ) {
+                    continue;
+                }
+                if ( file->featuresSatisfied(minimumFeatures()) && file->topContext() ) {
+                    if ( ! file->needsUpdate() ) {
+                        upToDate = file->topContext();
+                    }
+                    else if ( lastParsedContentHash(document()) == contentHash ) {
+                        unchangedContents = file;
+                    }
                 }
-                return;
+                break;
+            }
+        }
+        if ( unchangedContents ) {
+            // Only the modification time changed (e.g. by a checkout, or by saving without changes).
+            // The file still needs to be parsed if one of its imports changed.
+            TimedDUChainWriteLocker lock("DUChain write lock (ParseJob)");
+            unchangedContents->setModificationRevision(contents().modification);
+            if ( ! unchangedContents->needsUpdate() ) {
+                upToDate = unchangedContents->topContext();
             }
-            break;
+        }
+        if ( upToDate ) {
+            qDebug() << " ====> NOOP    ====> Already up to date:" << document().str();
+            setLastParsedContentHash(document(), contentHash);
+            setDuChain(upToDate);
+            if ( ICore::self()->languageController()->backgroundParser()->trackerForUrl(document()) ) {
+                highlightDUChain();
+            }
+            return;
         }
     }
     
+    // measures the actual parsing work, excluding documents which were found to be up to date
+    QElapsedTimer parseTimer;
+    parseTimer.start();
+
     ReferencedTopDUContext toUpdate = 0;
     {
-        DUChainReadLocker lock;
+        TimedDUChainReadLocker lock("DUChain read lock (ParseJob)");
         toUpdate = DUChainUtils::standardContextForUrl(document().toUrl());
     }
     if ( toUpdate ) {
@@ -152,30 +205,59 @@ void ParseJob::run(ThreadWeaver::JobPointer /*self*/, ThreadWeaver::Thread* /*th
     m_currentSession->setCurrentDocument(document());
     
     // call the python API and the AST transformer to populate the syntax tree
-    QPair<CodeAst::Ptr, bool> parserResults = m_currentSession->parse();
+    QPair<CodeAst::Ptr, bool> parserResults;
+    {
+        ParseProfilerScope profile(profiledFile, ParseProfiler::BuildAst);
+        parserResults = m_currentSession->parse();
+    }
     m_ast = parserResults.first;
 
     auto editor = QSharedPointer<PythonEditorIntegrator>(new PythonEditorIntegrator(m_currentSession.data()));
     // if parsing succeeded, continue and do semantic analysis
     if ( parserResults.second )
     {
+        // nothing was changed yet, the previous context is still intact
+        if ( abortRequested() ) {
+            return abortJob();
+        }
         // set up the declaration builder, it gets the parsePriority so it can re-schedule imported files with a better priority
         DeclarationBuilder builder(editor.data(), parsePriority());
         builder.setCurrentlyParsedDocument(document());
         builder.setFutureModificationRevision(contents().modification);
+        // An existing context is updated in place, stopping half-way would delete the declarations not
+        // reached yet, and files importing this one would miss them until the next full parse.
+        // Only new contexts are left incomplete when the job is aborted. They are registered in the DUChain
+        // already, so documents parsed meanwhile might import them incomplete; abortIncompleteBuild() only
+        // makes sure the next parse of this document builds them completely.
+        if ( ! toUpdate ) {
+            builder.setParseJob(this);
+        }
 
         // Run the declaration builder. If necessary, it will run itself again.
         m_duContext = builder.build(document(), m_ast.data(), toUpdate.data());
         if ( abortRequested() ) {
-            return abortJob();
+            return abortIncompleteBuild();
         }
         
         setDuChain(m_duContext);
         
-        // gather uses of variables and functions on the document
-        UseBuilder usebuilder(editor.data(), builder.missingModules());
-        usebuilder.setCurrentlyParsedDocument(document());
-        usebuilder.buildUses(m_ast.data());
+        // gather uses of variables and functions on the document.
+        // Documentation files only serve as a source of declarations for other files, so their uses
+        // are only built when requested (i.e. when the file is opened in the editor).
+        static const auto usesFeature = TopDUContext::AllDeclarationsContextsAndUses;
+        const bool buildUses = ( minimumFeatures() & usesFeature ) == usesFeature || ! Helper::isDocumentationFile(document());
+        QVector<ProblemPointer> useProblems;
+        if ( buildUses ) {
+            ParseProfilerScope profile(profiledFile, ParseProfiler::UseBuild);
+            UseBuilder usebuilder(editor.data(), builder.missingModules());
+            usebuilder.setCurrentlyParsedDocument(document());
+            usebuilder.setParseJob(this);
+            usebuilder.buildUses(m_ast.data());
+            if ( usebuilder.wasAborted() ) {
+                return abortIncompleteBuild();
+            }
+            useProblems = usebuilder.takeReportedProblems();
+        }
         
         // check whether any unresolved imports were encountered
         bool needsReparse = ! builder.unresolvedImports().isEmpty();
@@ -184,7 +266,7 @@ void ParseJob::run(ThreadWeaver::JobPointer /*self*/, ThreadWeaver::Thread* /*th
             // check whether one of the imports is queued for parsing, this is to avoid deadlocks
             // it's also ok if the duchain is now available (and thus has been parsed before already)
             bool dependencyInQueue = false;
-            DUChainWriteLocker lock;
+            TimedDUChainReadLocker lock("DUChain read lock (ParseJob)");
             foreach ( const IndexedString& url, builder.unresolvedImports() ) {
                 dependencyInQueue = KDevelop::ICore::self()->languageController()->backgroundParser()->isQueued(url);
                 dependencyInQueue = dependencyInQueue || DUChain::self()->chainForDocument(url);
@@ -202,14 +284,25 @@ void ParseJob::run(ThreadWeaver::JobPointer /*self*/, ThreadWeaver::Thread* /*th
             }
         }
         
-        // some internal housekeeping work
+        // Commit everything the builders collected, and do some internal housekeeping work.
+        // This is done in a single write-locked phase, to keep the time other threads are blocked short.
+        const auto declarationProblems = builder.takeReportedProblems();
         {
-            DUChainWriteLocker lock(DUChain::lock());
+            ParseProfilerScope profile(profiledFile, ParseProfiler::Commit);
+            TimedDUChainWriteLocker lock("DUChain write lock (ParseJob commit)");
+            foreach ( const ProblemPointer& p, declarationProblems + useProblems ) {
+                m_duContext->addProblem(p);
+            }
+            // The parser might have given us some syntax errors, which are now added to the document.
+            foreach ( const ProblemPointer& p, m_currentSession->m_problems ) {
+                m_duContext->addProblem(p);
+            }
             m_duContext->setFeatures(minimumFeatures());
             ParsingEnvironmentFilePointer parsingEnvironmentFile = m_duContext->parsingEnvironmentFile();
             parsingEnvironmentFile->setModificationRevision(contents().modification);
             DUChain::self()->updateContextEnvironment(m_duContext, parsingEnvironmentFile.data());
         }
+        setLastParsedContentHash(document(), contentHash);
         
         qDebug() << "---- Parsing Succeeded ----";
         
@@ -218,12 +311,14 @@ void ParseJob::run(ThreadWeaver::JobPointer /*self*/, ThreadWeaver::Thread* /*th
         }
         
         // start the code highlighter if parsing was successful.
+        ParseProfilerScope profile(profiledFile, ParseProfiler::Highlighting);
         highlightDUChain();
     }
     else {
         // No syntax tree was received from the parser, the expected reason for this is a syntax error in the document.
         qWarning() << "---- Parsing FAILED ----";
-        DUChainWriteLocker lock;
+        setLastParsedContentHash(document(), QByteArray());
+        TimedDUChainWriteLocker lock("DUChain write lock (ParseJob commit)");
         m_duContext = toUpdate.data();
         // if there's already a chain for the document, do some cleanup.
         if ( m_duContext ) {
@@ -244,30 +339,36 @@ void ParseJob::run(ThreadWeaver::JobPointer /*self*/, ThreadWeaver::Thread* /*th
             Q_ASSERT(m_duContext->type() == DUContext::Global);
         }
         
+        // The parser might have given us some syntax errors, which are now added to the document.
+        foreach ( const ProblemPointer& p, m_currentSession->m_problems ) {
+            m_duContext->addProblem(p);
+        }
+        
         setDuChain(m_duContext);
     }
     
     if ( abortRequested() ) {
         return abortJob();
     }
-    
-    // The parser might have given us some syntax errors, which are now added to the document.
-    DUChainWriteLocker lock;
-    foreach ( const ProblemPointer& p, m_currentSession->m_problems ) {
-        m_duContext->addProblem(p);
-    }
 
-    // If enabled, and if the document is open, do PEP8 checking.
-    eventuallyDoPEP8Checking(document(), m_duContext);
-    
     if ( minimumFeatures() & TopDUContext::AST ) {
-        DUChainWriteLocker lock;
+        TimedDUChainWriteLocker lock("DUChain write lock (ParseJob)");
         m_currentSession->ast = m_ast;
         m_duContext->setAst(QExplicitlySharedDataPointer<IAstContainer>(m_currentSession.data()));
     }
     
     setDuChain(m_duContext);
     DUChain::self()->emitUpdateReady(document(), duChain());
+
+    static_cast<LanguageSupport*>(languageSupport())->setLastParseDuration(document(), parseTimer.elapsed());
+    ParseProfiler::record(profiledFile, ParseProfiler::LockWait, jobStart, LockStatistics::threadWaitNsecs() - lockWaitAtStart);
+    ParseProfiler::recordParse(profiledFile);
+
+    // If enabled, and if the document is open, do PEP8 checking. This happens asynchronously,
+    // the problems are added to the context once the checker has finished.
+    if ( ICore::self()->languageController()->backgroundParser()->trackerForUrl(document()) ) {
+        static_cast<LanguageSupport*>(languageSupport())->pep8Checker()->scheduleCheck(document().toUrl());
+    }
 }
 
 ControlFlowGraph* ParseJob::controlFlowGraph()
@@ -280,90 +381,6 @@ DataAccessRepository* ParseJob::dataAccessInformation()
     return nullptr;
 }
 
-void ParseJob::eventuallyDoPEP8Checking(const IndexedString document, TopDUContext* topContext)
-{
-    IDocument* idoc = ICore::self()->documentController()->documentForUrl(document.toUrl());
-    if ( ! idoc || ! topContext || ! idoc->textDocument() || topContext->features() & PEP8Checking ) {
-        return;
-    }
-
-    KConfig config("kdevpythonsupportrc");
-    KConfigGroup configGroup = config.group("pep8");
-    if ( ! PEP8KCModule::isPep8Enabled(configGroup) ) {
-        return;
-    }
-    {
-        DUChainWriteLocker lock;
-        topContext->setFeatures((TopDUContext::Features) ( topContext->features() | PEP8Checking ));
-    }
-    qDebug() << "doing pep8 checking";
-    // TODO that's not very elegant, better would be making pep8 read from stdin -- but it doesn't support that atm
-    QTemporaryFile tempfile;
-    tempfile.open();
-    tempfile.write(idoc->textDocument()->text().toUtf8());
-    tempfile.close();
-    QString url = PEP8KCModule::pep8Path(configGroup);
-    QString arguments = PEP8KCModule::pep8Arguments(configGroup);
-    QFileInfo f(url);
-    bool error = false;
-    if ( url.isEmpty() || ! f.isExecutable() ) {
-        error = true;
-        return; // don't bother executing an invalid executable
-    }
-    // create a string that contains the command to call pep8 with the given arguments
-    QStringList commandArgs = (QStringList() << tempfile.fileName() << KShell::splitArgs(arguments));
-    QProcess process;
-    process.setProcessChannelMode(QProcess::MergedChannels);
-    // call the pep8 command
-    process.start(url, commandArgs);
-    process.waitForFinished(1000);
-    if ( process.state() != QProcess::NotRunning || ( process.exitCode() != 0 && process.exitCode() != 1 )  ) {
-        process.kill();
-        error = true;
-    }
-    else {
-        QByteArray data = process.readAll();
-        QList<QByteArray> errors = data.split('\n');
-        QRegExp errorFormat("(.*):(\\d*):(\\d*): (.*)", Qt::CaseInsensitive, QRegExp::RegExp2);
-        DUChainWriteLocker lock;
-        foreach ( const QByteArray& error, errors ) {
-            if ( errorFormat.exactMatch(error.data()) ) {
-                const QStringList texts = errorFormat.capturedTexts();
-                bool lineno_ok = false;
-                bool colno_ok = false;
-                int lineno = texts.at(2).toInt(&lineno_ok);
-                int colno = texts.at(3).toInt(&colno_ok);
-                if ( ! lineno_ok || ! colno_ok ) {
-                    qDebug() << "invalid line / col number:" << texts;
-                    continue;
-                }
-                QString error = texts.at(4);
-                KDevelop::Problem *p = new KDevelop::Problem();
-                p->setFinalLocation(DocumentRange(document, KTextEditor::Range(lineno - 1, qMax(colno - 4, 0),
-                                                                        lineno - 1, colno + 4)));
-                p->setSource(KDevelop::IProblem::Preprocessor);
-                p->setSeverity(error.startsWith('W') ? KDevelop::IProblem::Hint : KDevelop::IProblem::Warning);
-                p->setDescription(i18n("PEP8 checker error: %1", error));
-                ProblemPointer ptr(p);
-                topContext->addProblem(ptr);
-            }
-            else {
-                qDebug() << "invalid pep8 error line:" << error;
-            }
-        }
-    }
-    if ( error ) {
-        DUChainWriteLocker lock;
-        KDevelop::Problem *p = new KDevelop::Problem();
-        p->setFinalLocation(DocumentRange(document, KTextEditor::Range(0, 0, 0, 0)));
-        p->setSource(KDevelop::IProblem::Preprocessor);
-        p->setSeverity(KDevelop::IProblem::Warning);
-        p->setDescription(i18n("The selected PEP8 syntax checker \"%1\" does not seem to work correctly.", url));
-        ProblemPointer ptr(p);
-        topContext->addProblem(ptr);
-    }
-}
-
 }
 
 // kate: space-indent on; indent-width 4; tab-width 4; replace-tabs on; auto-insert-doxygen on
@@ -54,7 +54,6 @@ public:
 
     virtual CodeAst* ast() const;
     bool wasReadFromDisk() const;
-    static void eventuallyDoPEP8Checking(const IndexedString document, TopDUContext* topContext);
 
     ControlFlowGraph* controlFlowGraph() override;
     DataAccessRepository* dataAccessInformation() override;
@@ -63,7 +62,10 @@ protected:
     void run(ThreadWeaver::JobPointer self, ThreadWeaver::Thread* thread) override;
 
 private:
-    QList<QUrl> m_cachedCustomIncludes;
+    /// Abort the job after the builders were stopped, leaving a new context without some declarations,
+    /// or an existing one without some uses.
+    void abortIncompleteBuild();
+
     CodeAst::Ptr m_ast;
     bool m_readFromDisk;
     KDevelop::ReferencedTopDUContext m_duContext;